@@ -23,6 +23,13 @@ struct IClass {
 
 template <size_t = 0> struct Class : IClass {};
 
+// Same as dynamic_container_traits with container counters enabled, see
+// container::counters()
+struct dynamic_container_counters_traits : dingo::dynamic_container_traits {
+    template <typename> using rebind_t = dynamic_container_counters_traits;
+    static constexpr bool counters_enabled = true;
+};
+
 bool is_empty(const std::string& val) { return val.empty(); }
 
 bool is_empty(const int& val) { return val == 0; }
@@ -218,6 +225,9 @@ BENCHMARK_TEMPLATE(resolve_container_unique_int,
 BENCHMARK_TEMPLATE(resolve_container_unique_int,
                    dingo::dynamic_container_traits)
     ->UseRealTime();
+BENCHMARK_TEMPLATE(resolve_container_unique_int,
+                   dynamic_container_counters_traits)
+    ->UseRealTime();
 BENCHMARK_TEMPLATE(resolve_container_unique_string,
                    dingo::static_container_traits<>)
     ->UseRealTime();
@@ -229,6 +239,11 @@ BENCHMARK_TEMPLATE(resolve_container_shared, dingo::static_container_traits<>)
     ->UseRealTime();
 BENCHMARK_TEMPLATE(resolve_container_shared, dingo::dynamic_container_traits)
     ->UseRealTime();
+BENCHMARK_TEMPLATE(resolve_container_shared, dynamic_container_counters_traits)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(resolve_container_shared, dynamic_container_counters_traits)
+    ->UseRealTime()
+    ->Threads(4);
 
 BENCHMARK_TEMPLATE(resolve_container_shared_ptr,
                    dingo::static_container_traits<>)
@@ -0,0 +1,238 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/factory/constructor.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+// Shape of a synthetic dependency graph. Types are split into Depth layers of
+// equal width and each type depends on FanOut types of the following layer, so
+// types of the first layer are roots of the graph. SharedPercent of types is
+// registered with shared scope and Interfaces interfaces, the rest with unique
+// scope.
+template <size_t Types, size_t Depth, size_t FanOut, size_t SharedPercent,
+          size_t Interfaces>
+struct graph_shape {
+    static constexpr size_t types = Types;
+    static constexpr size_t width = Types / Depth;
+    static constexpr size_t interfaces = Interfaces;
+
+    static_assert(Types % Depth == 0);
+    static_assert(FanOut <= width);
+
+    static constexpr bool is_shared(size_t id) {
+        return (id * 37 + 11) % 100 < SharedPercent;
+    }
+
+    static constexpr size_t dependencies(size_t id) {
+        return id / width + 1 < Depth ? FanOut : 0;
+    }
+
+    static constexpr size_t dependency(size_t id, size_t i) {
+        return (id / width + 1) * width + (id % width * FanOut + i) % width;
+    }
+};
+
+template <typename Shape, size_t Id, size_t Interface> struct graph_interface {
+    virtual ~graph_interface() {}
+};
+
+template <typename Shape, size_t Id> struct graph_node;
+
+// Shared types are injected by reference, unique types by value
+template <typename Shape, size_t Id>
+using graph_dependency_t =
+    std::conditional_t<Shape::is_shared(Id), graph_node<Shape, Id>&,
+                       graph_node<Shape, Id>>;
+
+template <typename Shape, size_t Id,
+          typename = std::make_index_sequence<Shape::dependencies(Id)>>
+struct graph_node_base;
+
+template <typename Shape, size_t Id, size_t... Is>
+struct graph_node_base<Shape, Id, std::index_sequence<Is...>> {
+    using constructor_type = dingo::constructor<graph_node<Shape, Id>(
+        graph_dependency_t<Shape, Shape::dependency(Id, Is)>...)>;
+
+    graph_node_base(graph_dependency_t<Shape, Shape::dependency(Id, Is)>...) {}
+};
+
+template <typename Shape, size_t Id,
+          typename = std::make_index_sequence<Shape::interfaces>>
+struct graph_node_interfaces;
+
+template <typename Shape, size_t Id, size_t... Is>
+struct graph_node_interfaces<Shape, Id, std::index_sequence<Is...>>
+    : graph_interface<Shape, Id, Is>... {
+    using interfaces_type = dingo::interfaces<graph_node<Shape, Id>,
+                                              graph_interface<Shape, Id, Is>...>;
+};
+
+template <typename Shape, size_t Id>
+struct graph_node : graph_node_base<Shape, Id>,
+                    graph_node_interfaces<Shape, Id> {
+    using graph_node_base<Shape, Id>::graph_node_base;
+
+    size_t value = Id;
+};
+
+template <typename Shape, size_t Id, typename Container>
+void register_node(Container& container) {
+    using namespace dingo;
+    using node_type = graph_node<Shape, Id>;
+    using factory_type =
+        factory<typename graph_node_base<Shape, Id>::constructor_type>;
+    if constexpr (Shape::is_shared(Id)) {
+        container.template register_type<
+            scope<shared>, storage<node_type>,
+            typename graph_node_interfaces<Shape, Id>::interfaces_type,
+            factory_type>();
+    } else {
+        container.template register_type<scope<unique>, storage<node_type>,
+                                         factory_type>();
+    }
+}
+
+template <typename Shape, typename Container, size_t... Ids>
+void register_graph(Container& container, std::index_sequence<Ids...>) {
+    (register_node<Shape, Ids>(container), ...);
+}
+
+template <typename Shape, typename Container>
+void register_graph(Container& container) {
+    register_graph<Shape>(container, std::make_index_sequence<Shape::types>());
+}
+
+template <typename Shape, size_t Id, typename Container>
+size_t resolve_node(Container& container) {
+    return container.template resolve<graph_dependency_t<Shape, Id>>().value;
+}
+
+// Resolves the roots, constructing the whole graph on the first resolution
+template <typename Shape, typename Container, size_t... Ids>
+size_t resolve_graph(Container& container, std::index_sequence<Ids...>) {
+    return (resolve_node<Shape, Ids>(container) + ...);
+}
+
+template <typename Shape, typename Container>
+size_t resolve_graph(Container& container) {
+    return resolve_graph<Shape>(container,
+                                std::make_index_sequence<Shape::width>());
+}
+
+// Benchmarked containers have diagnostics so their memory usage is reported
+template <typename Container>
+void set_memory_counters(benchmark::State& state, Container& container) {
+    auto usage = container.memory_usage();
+    state.counters["memory"] = static_cast<double>(usage.total());
+}
+
+template <typename ContainerTraits, typename Shape>
+static void graph_register(benchmark::State& state) {
+    using container_type = dingo::container<
+        dingo::diagnostics_container_traits<ContainerTraits>>;
+    for (auto _ : state) {
+        container_type container;
+        register_graph<Shape>(container);
+
+        state.PauseTiming();
+        set_memory_counters(state, container);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * Shape::types);
+}
+
+template <typename ContainerTraits, typename Shape>
+static void graph_resolve_cold(benchmark::State& state) {
+    using container_type = dingo::container<
+        dingo::diagnostics_container_traits<ContainerTraits>>;
+    size_t count = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto container = std::make_unique<container_type>();
+        register_graph<Shape>(*container);
+        state.ResumeTiming();
+
+        count += resolve_graph<Shape>(*container);
+
+        state.PauseTiming();
+        set_memory_counters(state, *container);
+        container.reset();
+        state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(count);
+    state.SetItemsProcessed(state.iterations() * Shape::width);
+}
+
+template <typename ContainerTraits, typename Shape>
+static void graph_resolve_warm(benchmark::State& state) {
+    using container_type = dingo::container<
+        dingo::diagnostics_container_traits<ContainerTraits>>;
+    container_type container;
+    register_graph<Shape>(container);
+    size_t count = resolve_graph<Shape>(container);
+    for (auto _ : state) {
+        count += resolve_graph<Shape>(container);
+    }
+    benchmark::DoNotOptimize(count);
+    set_memory_counters(state, container);
+    state.SetItemsProcessed(state.iterations() * Shape::width);
+}
+
+// Few layers of mostly unique types
+using small_graph = graph_shape<24, 3, 2, 50, 1>;
+// Deeper graph of mostly shared types with multiple interfaces
+using large_graph = graph_shape<120, 6, 3, 75, 2>;
+
+BENCHMARK_TEMPLATE(graph_register, dingo::static_container_traits<>,
+                   small_graph)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(graph_register, dingo::dynamic_container_traits,
+                   small_graph)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(graph_register, dingo::static_container_traits<>,
+                   large_graph)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(graph_register, dingo::dynamic_container_traits,
+                   large_graph)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(graph_resolve_cold, dingo::static_container_traits<>,
+                   small_graph)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(graph_resolve_cold, dingo::dynamic_container_traits,
+                   small_graph)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(graph_resolve_cold, dingo::static_container_traits<>,
+                   large_graph)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(graph_resolve_cold, dingo::dynamic_container_traits,
+                   large_graph)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(graph_resolve_warm, dingo::static_container_traits<>,
+                   small_graph)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(graph_resolve_warm, dingo::dynamic_container_traits,
+                   small_graph)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(graph_resolve_warm, dingo::static_container_traits<>,
+                   large_graph)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(graph_resolve_warm, dingo::dynamic_container_traits,
+                   large_graph)
+    ->UseRealTime();
+} // namespace
@@ -6,6 +6,7 @@
 //
 
 #include <dingo/container.h>
+#include <dingo/dispatch_table.h>
 #include <dingo/index/array.h>
 #include <dingo/index/map.h>
 #include <dingo/index/unordered_map.h>
@@ -98,6 +99,24 @@ static void index_ptr_shared(benchmark::State& state) {
     state.SetBytesProcessed(state.iterations());
 }
 
+template <typename Container>
+static void index_ptr_shared_dispatch_table(benchmark::State& state) {
+    using namespace dingo;
+    Container container;
+    container.template register_indexed_type<
+        scope<shared>, storage<std::shared_ptr<Processor<>>>,
+        interfaces<IProcessor>>(size_t(1));
+
+    auto table = make_dispatch_table<std::shared_ptr<IProcessor>&, size_t>(
+        container);
+    MessageWrapper msg(Message{1});
+    for (auto _ : state) {
+        table.resolve(size_t(1))->process(msg);
+    }
+
+    state.SetBytesProcessed(state.iterations());
+}
+
 template <typename IndexType>
 struct static_container_traits : dingo::static_container_traits<void> {
     using index_definition_type = std::tuple<std::tuple<size_t, IndexType>>;
@@ -145,6 +164,15 @@ BENCHMARK_TEMPLATE(
         dynamic_container_traits<dingo::index_type::unordered_map>>)
     ->UseRealTime();
 
+BENCHMARK_TEMPLATE(
+    index_ptr_shared_dispatch_table,
+    dingo::container<dynamic_container_traits<dingo::index_type::array<10>>>)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(
+    index_ptr_shared_dispatch_table,
+    dingo::container<dynamic_container_traits<dingo::index_type::map>>)
+    ->UseRealTime();
+
 BENCHMARK_TEMPLATE(
     index_ptr_unique,
     dingo::container<dynamic_container_traits<dingo::index_type::array<10>>>)
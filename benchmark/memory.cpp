@@ -0,0 +1,334 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/storage/external.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/shared_cyclical.h>
+#include <dingo/storage/unique.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+// Registers 1000 types in memory_register benchmarks. Each registered type
+// adds about 0.1s to the compilation, so it is disabled by default.
+#if !defined(DINGO_BENCHMARK_MEMORY_LARGE)
+#define DINGO_BENCHMARK_MEMORY_LARGE 0
+#endif
+
+namespace {
+
+template <size_t> struct IClass {
+    virtual ~IClass() {}
+};
+
+struct Class : IClass<0>, IClass<1>, IClass<2>, IClass<3>, IClass<4> {};
+
+template <typename Container>
+void set_memory_counters(benchmark::State& state, Container& container) {
+    auto usage = container.memory_usage();
+    state.counters["total"] = static_cast<double>(usage.total());
+    state.counters["factories"] = static_cast<double>(usage.factories);
+    state.counters["storages"] = static_cast<double>(usage.storages);
+    state.counters["conversions"] = static_cast<double>(usage.conversions);
+}
+
+template <typename ContainerTraits>
+static void memory_shared_ptr_interfaces(benchmark::State& state) {
+    using namespace dingo;
+    using container_type =
+        container<diagnostics_container_traits<ContainerTraits>>;
+    for (auto _ : state) {
+        container_type container;
+        container.template register_type<
+            scope<shared>, storage<std::shared_ptr<Class>>,
+            interfaces<IClass<0>, IClass<1>, IClass<2>, IClass<3>,
+                       IClass<4>>>();
+        benchmark::DoNotOptimize(container.template resolve<IClass<0>&>());
+
+        state.PauseTiming();
+        set_memory_counters(state, container);
+        state.ResumeTiming();
+    }
+}
+
+template <typename ContainerTraits>
+static void memory_shared_ptr_interfaces_converted(benchmark::State& state) {
+    using namespace dingo;
+    using container_type =
+        container<diagnostics_container_traits<ContainerTraits>>;
+    for (auto _ : state) {
+        container_type container;
+        container.template register_type<
+            scope<shared>, storage<std::shared_ptr<Class>>,
+            interfaces<IClass<0>, IClass<1>, IClass<2>, IClass<3>,
+                       IClass<4>>>();
+        benchmark::DoNotOptimize(
+            container.template resolve<std::shared_ptr<IClass<0>>&>());
+
+        state.PauseTiming();
+        set_memory_counters(state, container);
+        state.ResumeTiming();
+    }
+}
+
+// Allocations done through counting_allocator
+struct allocation_counter {
+    static inline size_t allocated = 0;
+    static inline size_t allocations = 0;
+    static inline size_t current = 0;
+    static inline size_t peak = 0;
+
+    static void reset() { allocated = allocations = current = peak = 0; }
+};
+
+template <typename T> class counting_allocator {
+  public:
+    using value_type = T;
+
+    counting_allocator() noexcept {}
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+
+    value_type* allocate(std::size_t n) {
+        allocation_counter::allocated += n * sizeof(value_type);
+        allocation_counter::allocations += 1;
+        allocation_counter::current += n * sizeof(value_type);
+        allocation_counter::peak =
+            std::max(allocation_counter::peak, allocation_counter::current);
+        return static_cast<value_type*>(::operator new(n * sizeof(value_type)));
+    }
+
+    void deallocate(value_type* p, std::size_t n) noexcept {
+        allocation_counter::current -= n * sizeof(value_type);
+        ::operator delete(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const counting_allocator<T>&,
+                const counting_allocator<U>&) noexcept {
+    return true;
+}
+template <typename T, typename U>
+bool operator!=(const counting_allocator<T>& x,
+                const counting_allocator<U>& y) noexcept {
+    return !(x == y);
+}
+
+template <size_t N> struct Registered {
+    size_t value = N;
+};
+
+template <typename T> using value_storage = T;
+template <typename T> using pointer_storage = T*;
+template <typename T> using unique_ptr_storage = std::unique_ptr<T>;
+template <typename T> using shared_ptr_storage = std::shared_ptr<T>;
+
+template <typename Scope, template <typename> typename Storage>
+struct registration {
+    template <size_t N, typename Container>
+    static void apply(Container& container) {
+        using namespace dingo;
+        container.template register_type<scope<Scope>,
+                                         storage<Storage<Registered<N>>>>();
+    }
+};
+
+template <typename T> struct external_instance {
+    static T& get() {
+        static T instance;
+        return instance;
+    }
+};
+
+template <typename T> struct external_instance<T*> {
+    static T* get() { return &external_instance<T>::get(); }
+};
+
+template <typename T> struct external_instance<std::shared_ptr<T>> {
+    static std::shared_ptr<T>& get() {
+        static std::shared_ptr<T> instance = std::make_shared<T>();
+        return instance;
+    }
+};
+
+template <template <typename> typename Storage>
+struct registration<dingo::external, Storage> {
+    template <size_t N, typename Container>
+    static void apply(Container& container) {
+        using namespace dingo;
+        using storage_type = Storage<Registered<N>>;
+        container
+            .template register_type<scope<external>, storage<storage_type>>(
+                external_instance<storage_type>::get());
+    }
+};
+
+template <typename Registration, typename Container, size_t... Ns>
+void register_types(Container& container, std::index_sequence<Ns...>) {
+    (Registration::template apply<Ns>(container), ...);
+}
+
+// Bytes the container allocates to register Count types. Instances are not
+// resolved, so the bytes do not include shared instances constructed on the
+// first resolution.
+template <typename Registration, size_t Count>
+static void memory_register(benchmark::State& state) {
+    using container_type = dingo::container<dingo::dynamic_container_traits,
+                                            counting_allocator<char>>;
+    size_t allocated = 0;
+    size_t allocations = 0;
+    size_t peak = 0;
+    for (auto _ : state) {
+        allocation_counter::reset();
+        {
+            container_type container;
+            register_types<Registration>(container,
+                                         std::make_index_sequence<Count>());
+            allocated = allocation_counter::allocated;
+            allocations = allocation_counter::allocations;
+        }
+        peak = allocation_counter::peak;
+    }
+
+    state.counters["allocated"] = static_cast<double>(allocated);
+    state.counters["allocations"] = static_cast<double>(allocations);
+    state.counters["peak"] = static_cast<double>(peak);
+    state.counters["per_type"] = static_cast<double>(allocated) / Count;
+    state.SetItemsProcessed(state.iterations() * Count);
+}
+
+template <size_t Size> struct Temporary {
+    Temporary() {}
+    char data[Size] = {};
+};
+
+template <size_t Size> struct TemporaryUser {
+    TemporaryUser(Temporary<Size>&&, Temporary<Size>&&) {}
+};
+
+// Arena usage of a resolving context resolving a type with two temporaries
+template <size_t Size>
+static void memory_resolving_context(benchmark::State& state) {
+    using namespace dingo;
+    container<> container;
+    container.template register_type<scope<unique>, storage<Temporary<Size>>>();
+    container
+        .template register_type<scope<unique>, storage<TemporaryUser<Size>>>();
+
+    size_t used = 0;
+#if DINGO_ARENA_STATISTICS
+    size_t temporaries = 0;
+#endif
+    bool spilled = false;
+    for (auto _ : state) {
+        resolving_context context;
+        benchmark::DoNotOptimize(
+            context.template resolve<TemporaryUser<Size>>(container));
+        used = context.arena_used();
+#if DINGO_ARENA_STATISTICS
+        temporaries = context.temporaries();
+#endif
+        spilled = context.spilled();
+    }
+
+    state.counters["arena_used"] = static_cast<double>(used);
+#if DINGO_ARENA_STATISTICS
+    state.counters["temporaries"] = static_cast<double>(temporaries);
+#endif
+    state.counters["spilled"] = spilled;
+}
+
+BENCHMARK_TEMPLATE(memory_shared_ptr_interfaces,
+                   dingo::dynamic_container_traits);
+BENCHMARK_TEMPLATE(memory_shared_ptr_interfaces_converted,
+                   dingo::dynamic_container_traits);
+BENCHMARK_TEMPLATE(memory_shared_ptr_interfaces,
+                   dingo::static_container_traits<>);
+BENCHMARK_TEMPLATE(memory_shared_ptr_interfaces_converted,
+                   dingo::static_container_traits<>);
+
+BENCHMARK_TEMPLATE(memory_register, registration<dingo::unique, value_storage>,
+                   10);
+BENCHMARK_TEMPLATE(memory_register, registration<dingo::unique, value_storage>,
+                   100);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::unique, unique_ptr_storage>, 10);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::unique, unique_ptr_storage>, 100);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::unique, shared_ptr_storage>, 10);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::unique, shared_ptr_storage>, 100);
+BENCHMARK_TEMPLATE(memory_register, registration<dingo::shared, value_storage>,
+                   10);
+BENCHMARK_TEMPLATE(memory_register, registration<dingo::shared, value_storage>,
+                   100);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared, unique_ptr_storage>, 10);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared, unique_ptr_storage>, 100);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared, shared_ptr_storage>, 10);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared, shared_ptr_storage>, 100);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared_cyclical, value_storage>, 10);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared_cyclical, value_storage>, 100);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared_cyclical, shared_ptr_storage>,
+                   10);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared_cyclical, shared_ptr_storage>,
+                   100);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::external, value_storage>, 10);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::external, value_storage>, 100);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::external, pointer_storage>, 10);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::external, pointer_storage>, 100);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::external, shared_ptr_storage>, 10);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::external, shared_ptr_storage>, 100);
+
+#if DINGO_BENCHMARK_MEMORY_LARGE
+BENCHMARK_TEMPLATE(memory_register, registration<dingo::unique, value_storage>,
+                   1000);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::unique, unique_ptr_storage>, 1000);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::unique, shared_ptr_storage>, 1000);
+BENCHMARK_TEMPLATE(memory_register, registration<dingo::shared, value_storage>,
+                   1000);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared, unique_ptr_storage>, 1000);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared, shared_ptr_storage>, 1000);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared_cyclical, value_storage>, 1000);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::shared_cyclical, shared_ptr_storage>,
+                   1000);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::external, value_storage>, 1000);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::external, pointer_storage>, 1000);
+BENCHMARK_TEMPLATE(memory_register,
+                   registration<dingo::external, shared_ptr_storage>, 1000);
+#endif
+
+BENCHMARK_TEMPLATE(memory_resolving_context, 16);
+BENCHMARK_TEMPLATE(memory_resolving_context, DINGO_CONTEXT_ARENA_BUFFER_SIZE);
+} // namespace
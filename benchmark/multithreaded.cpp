@@ -0,0 +1,187 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/index/unordered_map.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+
+namespace {
+
+struct Counter {
+    Counter() {}
+    std::atomic<uint64_t> value{0};
+};
+
+struct IClass {
+    virtual ~IClass() {}
+    virtual size_t get() const = 0;
+};
+
+template <size_t N> struct Class : IClass {
+    size_t get() const override { return N; }
+};
+
+// Static containers of the same tag share registrations
+struct shared_threads_tag {};
+struct unique_threads_tag {};
+
+struct container_traits_indexed : dingo::dynamic_container_traits {
+    using index_definition_type =
+        std::tuple<std::tuple<size_t, dingo::index_type::unordered_map>>;
+};
+
+// Without cache, each resolution goes through the factory and reads its data
+struct container_traits_without_cache : dingo::dynamic_container_traits {
+    static constexpr bool cache_enabled = false;
+};
+
+// The first thread keeps writing into a shared instance while the other
+// threads resolve it, reading factory data that share a cache line with the
+// instance unless the instance is isolated
+template <typename Scope>
+static void resolve_shared_concurrent_write(benchmark::State& state) {
+    using namespace dingo;
+    using container_type = container<container_traits_without_cache>;
+    static container_type* container = [] {
+        static container_type instance;
+        instance.template register_type<scope<Scope>, storage<Counter>>();
+        instance.template resolve<Counter&>();
+        return &instance;
+    }();
+
+    if (state.thread_index() == 0) {
+        auto& counter = container->template resolve<Counter&>();
+        for (auto _ : state)
+            counter.value.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        // Readers only take the address, the instance itself is not touched
+        for (auto _ : state)
+            benchmark::DoNotOptimize(
+                &container->template resolve<Counter&>());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Containers are shared by the benchmark threads. Registrations are resolved
+// before the threads start, so the threads measure the resolution only, not
+// the construction of shared instances.
+template <typename ContainerTraits>
+static void resolve_shared_threads(benchmark::State& state) {
+    using namespace dingo;
+    using container_type = container<ContainerTraits>;
+    static container_type* container = [] {
+        static container_type instance;
+        instance.template register_type<scope<shared>, storage<Class<0>>,
+                                        interfaces<IClass>>();
+        instance.template resolve<IClass&>();
+        return &instance;
+    }();
+
+    size_t count = 0;
+    for (auto _ : state)
+        count += container->template resolve<IClass&>().get();
+    benchmark::DoNotOptimize(count);
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename ContainerTraits>
+static void resolve_unique_threads(benchmark::State& state) {
+    using namespace dingo;
+    using container_type = container<ContainerTraits>;
+    static container_type* container = [] {
+        static container_type instance;
+        instance.template register_type<scope<unique>,
+                                        storage<std::unique_ptr<Class<0>>>,
+                                        interfaces<IClass>>();
+        instance.template resolve<std::unique_ptr<IClass>>();
+        return &instance;
+    }();
+
+    size_t count = 0;
+    for (auto _ : state)
+        count += container->template resolve<std::unique_ptr<IClass>>()->get();
+    benchmark::DoNotOptimize(count);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void resolve_indexed_threads(benchmark::State& state) {
+    using namespace dingo;
+    using container_type = container<container_traits_indexed>;
+    static container_type* container = [] {
+        static container_type instance;
+        instance.register_indexed_type<scope<shared>, storage<Class<0>>,
+                                       interfaces<IClass>>(size_t(0));
+        instance.register_indexed_type<scope<shared>, storage<Class<1>>,
+                                       interfaces<IClass>>(size_t(1));
+        instance.resolve<IClass&>(size_t(0));
+        instance.resolve<IClass&>(size_t(1));
+        return &instance;
+    }();
+
+    size_t count = 0;
+    size_t index = size_t(state.thread_index()) % 2;
+    for (auto _ : state)
+        count += container->resolve<IClass&>(size_t(index)).get();
+    benchmark::DoNotOptimize(count);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Each thread resolves from its own child container, getting a unique type
+// registered in the child and a shared type walking to the shared parent
+static void resolve_child_container_threads(benchmark::State& state) {
+    using namespace dingo;
+    using container_type = container<>;
+    static container_type* parent = [] {
+        static container_type instance;
+        instance.register_type<scope<shared>, storage<Class<0>>,
+                               interfaces<IClass>>();
+        instance.resolve<IClass&>();
+        return &instance;
+    }();
+
+    container_type::child_container_type<void> child(parent);
+    child.register_type<scope<unique>, storage<Class<1>>>();
+
+    size_t count = 0;
+    for (auto _ : state) {
+        count += child.resolve<IClass&>().get();
+        count += child.resolve<Class<1>>().get();
+    }
+    benchmark::DoNotOptimize(count);
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK_TEMPLATE(resolve_shared_threads,
+                   dingo::static_container_traits<shared_threads_tag>)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(resolve_shared_threads, dingo::dynamic_container_traits)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(resolve_unique_threads,
+                   dingo::static_container_traits<unique_threads_tag>)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(resolve_unique_threads, dingo::dynamic_container_traits)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK(resolve_indexed_threads)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(resolve_child_container_threads)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_TEMPLATE(resolve_shared_concurrent_write, dingo::shared)
+    ->ThreadRange(2, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(resolve_shared_concurrent_write, dingo::shared_isolated)
+    ->ThreadRange(2, 8)
+    ->UseRealTime();
+
+} // namespace
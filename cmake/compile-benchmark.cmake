@@ -0,0 +1,25 @@
+# The benchmark drives the compiler with GCC-style command line
+if (MSVC)
+    message(STATUS "compile-benchmark target is not available with MSVC")
+    return()
+endif()
+
+find_program(PYTHON "python3")
+if (NOT PYTHON)
+    message(WARNING "python3 not found, compile-benchmark target is not available")
+    return()
+endif()
+
+set(DINGO_COMPILE_BENCHMARK_TYPES "0,25,50,100" CACHE STRING "comma-separated counts of types registered by compile-time benchmarks")
+
+add_custom_target(compile-benchmark
+    COMMENT "Measuring compile time and object size"
+    COMMAND ${PYTHON} ${PROJECT_SOURCE_DIR}/tools/compile_benchmark.py
+        --compiler ${CMAKE_CXX_COMPILER}
+        --include ${PROJECT_SOURCE_DIR}/include
+        --types ${DINGO_COMPILE_BENCHMARK_TYPES}
+        --flags "-std=c++${CMAKE_CXX_STANDARD} -O2"
+        --output ${CMAKE_BINARY_DIR}/compile-benchmark.json
+    WORKING_DIRECTORY ${PROJECT_SOURCE_DIR}
+    USES_TERMINAL
+)
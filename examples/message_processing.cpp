@@ -6,6 +6,7 @@
 //
 
 #include <dingo/container.h>
+#include <dingo/dispatch_table.h>
 #include <dingo/index/array.h>
 #include <dingo/storage/shared.h>
 #include <dingo/storage/unique.h>
@@ -89,4 +90,13 @@ int main() {
         container.template resolve<std::shared_ptr<IProcessor>>(msg.id())
             ->process(msg);
     }
+
+    // For hot paths, build a dense dispatch table once registrations are done.
+    // Shared processors are resolved upfront, so routing is a single lookup.
+    auto processors =
+        make_dispatch_table<std::shared_ptr<IProcessor>, size_t>(container);
+    {
+        MessageWrapper msg((MessageA{2}));
+        processors.resolve(msg.id())->process(msg);
+    }
 }
@@ -10,8 +10,14 @@
 #include <dingo/config.h>
 
 #include <memory>
+#include <type_traits>
 
 namespace dingo {
+// Allocators that can't allocate arrays (eg. static allocators) specialize
+// this to false
+template <typename Allocator>
+struct is_array_allocator : std::bool_constant<true> {};
+
 template <typename Allocator> struct allocator_base : public Allocator {
     template <typename AllocatorT>
     allocator_base(AllocatorT&& alloc)
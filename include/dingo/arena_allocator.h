@@ -7,12 +7,18 @@
 
 #pragma once
 
+#include <dingo/config.h>
+
+#include <dingo/allocator.h>
+
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <type_traits>
 
 namespace dingo {
 
@@ -21,11 +27,191 @@ template< typename T > struct arena_allocator_traits: std::allocator_traits< T >
     static constexpr intptr_t header_size() { return sizeof(uintptr_t) * 2; }
 };
 
+// Arena counters, collected only when DINGO_ARENA_STATISTICS is enabled
+struct arena_statistics {
+    // Bytes requested from the arena
+    std::size_t allocated = 0;
+    // Blocks requested from the underlying allocator
+    std::size_t blocks = 0;
+    // Blocks reused from the thread-local block cache
+    std::size_t cached_blocks = 0;
+    // Maximum of bytes used between resets
+    std::size_t high_water_mark = 0;
+
+    arena_statistics& operator+=(const arena_statistics& other) {
+        allocated += other.allocated;
+        blocks += other.blocks;
+        cached_blocks += other.cached_blocks;
+        high_water_mark = std::max(high_water_mark, other.high_water_mark);
+        return *this;
+    }
+};
+
+// Thread-local cache of arena blocks, so arenas that repeatedly spill to the
+// heap and get reset do not allocate after warm-up. Blocks are kept in size
+// classes of power-of-two multiples of a page, each class holds up to
+// DINGO_ARENA_BLOCK_CACHE_SIZE blocks. The cache state is trivially destructible
+// so arenas destroyed after the thread's cache was flushed still work, they
+// just release their blocks directly.
+template< typename Allocator > class arena_block_cache {
+    using allocator_traits_type = arena_allocator_traits< Allocator >;
+
+    static constexpr std::size_t page_size = allocator_traits_type::page_size();
+    static constexpr std::size_t header_size = allocator_traits_type::header_size();
+
+    static constexpr std::size_t size_classes() {
+        std::size_t classes = 0;
+        while ((page_size << classes) <= DINGO_ARENA_BLOCK_CACHE_MAX_BLOCK_SIZE)
+            ++classes;
+        return classes;
+    }
+
+    static constexpr std::size_t SizeClasses = size_classes();
+    static constexpr std::size_t Capacity = DINGO_ARENA_BLOCK_CACHE_SIZE;
+
+    struct state {
+        void* blocks[SizeClasses][Capacity];
+        uint8_t counts[SizeClasses];
+        bool registered;
+        bool flushed;
+    };
+
+    struct cleanup {
+        ~cleanup() {
+            auto& s = get_state();
+            Allocator allocator;
+            for (std::size_t i = 0; i < SizeClasses; ++i) {
+                while (s.counts[i])
+                    allocator_traits_type::deallocate(allocator,
+                        reinterpret_cast<uint8_t*>(s.blocks[i][--s.counts[i]]),
+                        (page_size << i) - header_size);
+            }
+            s.flushed = true;
+        }
+    };
+
+    static state& get_state() {
+        static thread_local state s;
+        return s;
+    }
+
+public:
+    static constexpr bool enabled =
+        Capacity > 0 && SizeClasses > 0 &&
+        std::allocator_traits< Allocator >::is_always_equal::value &&
+        std::is_default_constructible_v< Allocator >;
+
+    // Rounds block size up so it falls into a size class, if it can be cached
+    static std::size_t block_size(std::size_t size) {
+        std::size_t block = page_size;
+        while (block < size + header_size && block <= DINGO_ARENA_BLOCK_CACHE_MAX_BLOCK_SIZE)
+            block <<= 1;
+        return block <= DINGO_ARENA_BLOCK_CACHE_MAX_BLOCK_SIZE ? block - header_size : size;
+    }
+
+    static void* pop(std::size_t size) {
+        auto i = size_class(size);
+        if (i == SizeClasses)
+            return nullptr;
+        auto& s = get_state();
+        return s.counts[i] ? s.blocks[i][--s.counts[i]] : nullptr;
+    }
+
+    static bool push(void* ptr, std::size_t size) {
+        auto i = size_class(size);
+        if (i == SizeClasses)
+            return false;
+        auto& s = get_state();
+        if (s.flushed || s.counts[i] == Capacity)
+            return false;
+        if (!s.registered) {
+            // Registers cleanup for thread exit
+            static thread_local cleanup c;
+            (void)c;
+            s.registered = true;
+        }
+        s.blocks[i][s.counts[i]++] = ptr;
+        return true;
+    }
+
+private:
+    static std::size_t size_class(std::size_t size) {
+        for (std::size_t i = 0; i < SizeClasses; ++i) {
+            if ((page_size << i) == size + header_size)
+                return i;
+        }
+        return SizeClasses;
+    }
+};
+
+// Type-erased allocator arenas request their blocks from instead of their own
+// allocator, so arenas that are not parametrized by an allocator (eg. arenas of
+// resolving_context) can allocate from the allocator of a container. Blocks
+// are allocated as arrays of maximally aligned units. Default constructed
+// upstream is empty and the arena uses its own allocator.
+class arena_upstream {
+    struct unit {
+        alignas(std::max_align_t) unsigned char data[alignof(std::max_align_t)];
+    };
+
+  public:
+    static constexpr std::size_t alignment = sizeof(unit);
+
+    arena_upstream() = default;
+
+    template <typename Allocator> static arena_upstream make(Allocator& allocator) {
+        arena_upstream upstream;
+        upstream.allocate_ = &allocate_units<Allocator>;
+        upstream.deallocate_ = &deallocate_units<Allocator>;
+        upstream.allocator_ = &allocator;
+        return upstream;
+    }
+
+    explicit operator bool() const { return allocator_ != nullptr; }
+
+    void* allocate(std::size_t size) const { return allocate_(allocator_, size); }
+    void deallocate(void* ptr, std::size_t size) const { deallocate_(allocator_, ptr, size); }
+
+  private:
+    template <typename Allocator> static auto rebind(void* allocator) {
+        return typename std::allocator_traits<Allocator>::template rebind_alloc<unit>(
+            *static_cast<Allocator*>(allocator));
+    }
+
+    template <typename Allocator> static void* allocate_units(void* allocator, std::size_t size) {
+        assert(size % sizeof(unit) == 0);
+        auto alloc = rebind<Allocator>(allocator);
+        return std::allocator_traits<decltype(alloc)>::allocate(alloc, size / sizeof(unit));
+    }
+
+    template <typename Allocator> static void deallocate_units(void* allocator, void* ptr, std::size_t size) {
+        auto alloc = rebind<Allocator>(allocator);
+        std::allocator_traits<decltype(alloc)>::deallocate(
+            alloc, static_cast<unit*>(ptr), size / sizeof(unit));
+    }
+
+    void* (*allocate_)(void*, std::size_t) = nullptr;
+    void (*deallocate_)(void*, void*, std::size_t) = nullptr;
+    void* allocator_ = nullptr;
+};
+
+// Returns upstream allocating from the allocator, or an empty upstream if the
+// allocator can't allocate arrays
+template <typename Allocator> arena_upstream make_arena_upstream(Allocator& allocator) {
+    if constexpr (is_array_allocator<Allocator>::value) {
+        return arena_upstream::make(allocator);
+    } else {
+        (void)allocator;
+        return arena_upstream();
+    }
+}
+
 template< typename Allocator = std::allocator<uint8_t> > class arena
     : arena_allocator_traits< Allocator >::template rebind_alloc<uint8_t>
 {
     using allocator_type = typename arena_allocator_traits< Allocator >::template rebind_alloc<uint8_t>;
     using allocator_traits_type = arena_allocator_traits< allocator_type >;
+    using block_cache_type = arena_block_cache< allocator_type >;
 
     static constexpr std::size_t MaxBlockSize = 1<<21;
 
@@ -39,6 +225,7 @@ template< typename Allocator = std::allocator<uint8_t> > class arena
 
     block* block_initial_ = nullptr;
     std::size_t block_size_ = 0;
+    arena_upstream upstream_;
 
     struct state {
         block* block_head_ = nullptr;
@@ -49,6 +236,10 @@ template< typename Allocator = std::allocator<uint8_t> > class arena
 
     state state_;
 
+#if DINGO_ARENA_STATISTICS
+    arena_statistics statistics_;
+#endif
+
     bool request_block(intptr_t bytes) {
         assert(state_.block_size_ > 0);
 
@@ -63,8 +254,28 @@ template< typename Allocator = std::allocator<uint8_t> > class arena
         ) & ~(page_size - 1)) - header_size;
         if (size < 0)
             return false;
+        if (upstream_) {
+            constexpr intptr_t alignment = arena_upstream::alignment;
+            size = (size + alignment - 1) & ~(alignment - 1);
+        }
+        block* head = nullptr;
+        if constexpr (block_cache_type::enabled) {
+            if (!upstream_) {
+                size = block_cache_type::block_size(size);
+                head = reinterpret_cast<block*>(block_cache_type::pop(size));
+#if DINGO_ARENA_STATISTICS
+                if (head)
+                    ++statistics_.cached_blocks;
+#endif
+            }
+        }
         assert(size - (intptr_t)sizeof(block) >= bytes);
-        auto head = allocate_block(size);
+        if (!head) {
+            head = allocate_block(size);
+#if DINGO_ARENA_STATISTICS
+            ++statistics_.blocks;
+#endif
+        }
         head->size = size;
         head->owned = true;
         push_block(head);
@@ -73,7 +284,8 @@ template< typename Allocator = std::allocator<uint8_t> > class arena
     }
 
     block* allocate_block(intptr_t size) {
-        block *ptr = reinterpret_cast<block*>(allocator_traits_type::allocate(*this, size));
+        block *ptr = reinterpret_cast<block*>(upstream_ ?
+            upstream_.allocate(size) : allocator_traits_type::allocate(*this, size));
         assert((reinterpret_cast<intptr_t>(ptr) & (alignof(block) - 1)) == 0);
         return ptr;
     }
@@ -87,6 +299,14 @@ template< typename Allocator = std::allocator<uint8_t> > class arena
 
     void deallocate_block(block* ptr) {
         assert(ptr->owned);
+        if (upstream_) {
+            upstream_.deallocate(ptr, ptr->size);
+            return;
+        }
+        if constexpr (block_cache_type::enabled) {
+            if (block_cache_type::push(ptr, ptr->size))
+                return;
+        }
         allocator_traits_type::deallocate(*this, reinterpret_cast<uint8_t*>(ptr), ptr->size);
     }
 
@@ -122,6 +342,12 @@ public:
         static_assert(std::is_trivially_destructible_v<T>);
     }
 
+    // Arena over the buffer requesting further blocks from the upstream
+    template< typename T > arena(T& buffer, arena_upstream upstream)
+        : arena(buffer) {
+        upstream_ = upstream;
+    }
+
     arena(void* buffer, std::size_t size)
         : arena(buffer, size, size)
     {}
@@ -156,6 +382,10 @@ public:
         intptr_t ptr = state_.block_ptr_ + padding;
         assert((ptr & (alignment - 1)) == 0);
         state_.block_ptr_ = ptr + size;
+#if DINGO_ARENA_STATISTICS
+        statistics_.allocated += size;
+        statistics_.high_water_mark = std::max(statistics_.high_water_mark, used());
+#endif
         return reinterpret_cast<void*>(ptr);
     }
 
@@ -163,9 +393,54 @@ public:
 
     void reset() {
         deallocate_blocks(nullptr);
-        state_.block_head_ = nullptr;
+        state_ = state();
         state_.block_size_ = block_size_;
-        push_block(block_initial_);
+        if (block_initial_)
+            push_block(block_initial_);
+    }
+
+    // Makes sure the next allocations of up to size bytes will not need to
+    // request a new block
+    void reserve(std::size_t size) {
+        if (state_.block_end_ - state_.block_ptr_ < (intptr_t)size)
+            request_block(size);
+    }
+
+    // Returns true if blocks beyond the initial buffer were requested since
+    // construction or last reset
+    bool spilled() const { return state_.block_head_ != block_initial_; }
+
+    // Returns number of bytes used since construction or last reset
+    std::size_t used() const {
+        std::size_t size = 0;
+        for (auto head = state_.block_head_; head; head = head->next) {
+            if (head == state_.block_head_)
+                size += state_.block_ptr_ - reinterpret_cast<intptr_t>(head) - sizeof(block);
+            else
+                size += head->size - sizeof(block);
+        }
+        return size;
+    }
+
+#if DINGO_ARENA_STATISTICS
+    const arena_statistics& statistics() const { return statistics_; }
+#endif
+
+    // Returns number of bytes in blocks allocated by the arena
+    std::size_t size() const {
+        std::size_t size = 0;
+        for (auto head = state_.block_head_; head && head->owned; head = head->next)
+            size += head->size;
+        return size;
+    }
+
+    // Returns true if nothing was allocated since construction or last reset
+    bool empty() const {
+        if (state_.block_head_ != block_initial_)
+            return false;
+        return !block_initial_ ||
+               state_.block_ptr_ ==
+                   reinterpret_cast<intptr_t>(block_initial_) + (intptr_t)sizeof(block);
     }
 };
 
@@ -0,0 +1,172 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/aligned_storage.h>
+#include <dingo/allocator.h>
+#include <dingo/arena_allocator.h>
+#include <dingo/decay.h>
+#include <dingo/memory_usage.h>
+#include <dingo/observer.h>
+#include <dingo/static_allocator.h>
+
+#include <new>
+#include <utility>
+
+namespace dingo {
+class resolving_context;
+class type_validation;
+namespace detail {
+struct dependency_validator;
+}
+
+template <typename T, bool Inline> struct class_instance_container_storage {
+    void* get() { return nullptr; }
+};
+
+template <typename T> struct class_instance_container_storage<T, true> {
+    void* get() { return &storage_; }
+    aligned_storage_t<sizeof(T), alignof(T)> storage_;
+};
+
+// Per-registration container that is created on the first registration done
+// through it. Until then, resolution is forwarded directly to the parent
+// container. Static allocators allow a single allocation per type, so for them
+// the container is constructed in-place.
+template <typename Container>
+class class_instance_container
+    : class_instance_container_storage<
+          Container, is_static_allocator_v<typename Container::allocator_type>> {
+    using parent_container_type = typename Container::parent_container_type;
+    using allocator_type = typename Container::allocator_type;
+
+    static constexpr bool inline_storage =
+        is_static_allocator_v<allocator_type>;
+    using storage_type =
+        class_instance_container_storage<Container, inline_storage>;
+
+  public:
+    using container_type = Container;
+    using container_traits_type = typename Container::container_traits_type;
+
+    class_instance_container(parent_container_type* parent) : parent_(parent) {}
+
+    class_instance_container(const class_instance_container&) = delete;
+    class_instance_container&
+    operator=(const class_instance_container&) = delete;
+
+    ~class_instance_container() {
+        if (container_) {
+            if constexpr (inline_storage) {
+                container_->~Container();
+            } else {
+                auto alloc = allocator_traits::rebind<Container>(
+                    parent_->get_allocator());
+                allocator_traits::destroy(alloc, container_);
+                allocator_traits::deallocate(alloc, container_, 1);
+            }
+        }
+    }
+
+    Container& get() {
+        if (!container_) {
+            if constexpr (inline_storage) {
+                container_ = new (storage_type::get())
+                    Container(parent_, parent_->get_allocator());
+            } else {
+                auto alloc = allocator_traits::rebind<Container>(
+                    parent_->get_allocator());
+                Container* container = allocator_traits::allocate(alloc, 1);
+                if (!container)
+                    throw std::bad_alloc();
+                try {
+                    allocator_traits::construct(alloc, container, parent_,
+                                                parent_->get_allocator());
+                } catch (...) {
+                    allocator_traits::deallocate(alloc, container, 1);
+                    throw;
+                }
+                container_ = container;
+            }
+        }
+        return *container_;
+    }
+
+    bool has_container() const { return container_ != nullptr; }
+
+    // Returns the container if it was created, without creating it
+    Container* find() const { return container_; }
+
+    void get_memory_usage(container_memory_usage& usage) {
+        if constexpr (inline_storage) {
+            // In-place storage is a part of the factory
+            usage.factories -= sizeof(Container);
+            usage.containers += sizeof(Container);
+        } else if (container_) {
+            usage.containers += sizeof(Container);
+        }
+
+        if (container_)
+            container_->get_memory_usage(usage);
+    }
+
+    allocator_type& get_allocator() { return parent_->get_allocator(); }
+    arena_upstream get_arena_upstream() { return parent_->get_arena_upstream(); }
+
+    template <typename... TypeArgs, typename... Args>
+    auto& register_type(Args&&... args) {
+        return get().template register_type<TypeArgs...>(
+            std::forward<Args>(args)...);
+    }
+
+    template <typename... TypeArgs, typename... Args>
+    auto& register_indexed_type(Args&&... args) {
+        return get().template register_indexed_type<TypeArgs...>(
+            std::forward<Args>(args)...);
+    }
+
+    template <typename... TypeArgs, typename... Args>
+    auto& register_type_collection(Args&&... args) {
+        return get().template register_type_collection<TypeArgs...>(
+            std::forward<Args>(args)...);
+    }
+
+  private:
+    friend class resolving_context;
+    friend struct detail::dependency_validator;
+
+    template <typename T> void validate_dependency(type_validation& validation) {
+        if (container_)
+            container_->template validate_dependency<T>(validation);
+        else
+            parent_->template validate_dependency<T>(validation);
+    }
+
+    template <typename T, bool RemoveRvalueReferences, bool CheckCache = true,
+              typename... IdType>
+    decltype(auto) resolve(resolving_context& context, IdType&&... id) {
+        // Resolution of a dependency
+        [[maybe_unused]] resolve_observer_guard<
+            typename parent_container_type::observer_type,
+            typename parent_container_type::rtti_type, decay_t<T>>
+            observer_guard;
+
+        if (container_)
+            return container_->template resolve<T, RemoveRvalueReferences,
+                                                CheckCache>(
+                context, std::forward<IdType>(id)...);
+        return parent_->template resolve<T, RemoveRvalueReferences>(
+            context, std::forward<IdType>(id)...);
+    }
+
+    parent_container_type* parent_;
+    Container* container_ = nullptr;
+};
+} // namespace dingo
@@ -10,17 +10,76 @@
 #include <dingo/config.h>
 
 #include <dingo/aligned_storage.h>
+#include <dingo/allocator.h>
 #include <dingo/arena_allocator.h>
 #include <dingo/decay.h>
 #include <dingo/resettable_i.h>
 #include <dingo/type_list.h>
 
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <variant>
 
 namespace dingo {
 
-template< typename T > struct class_instance_conversion {
-    template< typename... Args > T& construct(Args&&... args) {
+// Conversions no larger than a pointer are kept inline. Larger conversions are
+// allocated through the container allocator on first use, so resolvers do not
+// reserve space for conversions that are never requested. Owner makes the
+// allocated type distinct, so static allocators provide a slot for each owner.
+template <typename Owner, typename T,
+          bool Inline = sizeof(T) <= sizeof(void*) &&
+                        alignof(T) <= alignof(void*)>
+struct class_instance_conversion {
+    struct conversion_instance {
+        template <typename... Args>
+        conversion_instance(Args&&... args)
+            : value(std::forward<Args>(args)...) {}
+
+        T value;
+    };
+
+    template <typename Allocator, typename... Args>
+    T& construct(Allocator& allocator, Args&&... args) {
+        if (!instance_) {
+            auto alloc =
+                allocator_traits::rebind<conversion_instance>(allocator);
+            conversion_instance* ptr = allocator_traits::allocate(alloc, 1);
+            if (!ptr)
+                throw std::bad_alloc();
+            try {
+                allocator_traits::construct(alloc, ptr,
+                                            std::forward<Args>(args)...);
+            } catch (...) {
+                allocator_traits::deallocate(alloc, ptr, 1);
+                throw;
+            }
+            instance_ = ptr;
+        }
+        return instance_->value;
+    }
+
+    template <typename Allocator> void reset(Allocator& allocator) {
+        if (instance_) {
+            auto alloc =
+                allocator_traits::rebind<conversion_instance>(allocator);
+            allocator_traits::destroy(alloc, instance_);
+            allocator_traits::deallocate(alloc, instance_, 1);
+            instance_ = nullptr;
+        }
+    }
+
+    std::size_t memory_usage() const {
+        return instance_ ? sizeof(conversion_instance) : 0;
+    }
+
+    conversion_instance* instance_ = nullptr;
+};
+
+template <typename Owner, typename T>
+struct class_instance_conversion<Owner, T, true> {
+    template <typename Allocator, typename... Args>
+    T& construct(Allocator&, Args&&... args) {
         auto* instance = reinterpret_cast<T*>(&storage_);
         if (initialized_) {
             return *instance;
@@ -31,7 +90,7 @@ template< typename T > struct class_instance_conversion {
         return *instance;
     }
 
-    void reset() {
+    template <typename Allocator> void reset(Allocator&) {
         if (initialized_) {
             if constexpr (!std::is_trivially_destructible_v<T>)
                 reinterpret_cast<T*>(&storage_)->~T();
@@ -39,23 +98,35 @@ template< typename T > struct class_instance_conversion {
         }
     }
 
+    // Inline storage is a part of the owner
+    std::size_t memory_usage() const { return 0; }
+
     aligned_storage_t<sizeof(T), alignof(T)> storage_;
     bool initialized_ = false;
 };
 
-template< typename... Types > struct class_instance_conversions
-    : class_instance_conversion< Types >...
+// Conversions are released through reset() with the allocator they were
+// constructed with
+template< typename Owner, typename... Types > struct class_instance_conversions
+    : class_instance_conversion< Owner, Types >...
 {
-    ~class_instance_conversions() {
-        reset();
+    template <typename T, typename Allocator, typename... Args>
+    T& construct(Allocator& allocator, Args&&... args) {
+        return static_cast<class_instance_conversion<Owner, T>&>(*this)
+            .construct(allocator, std::forward<Args>(args)...);
     }
 
-    template < typename T, typename... Args > T& construct(Args&&... args) {
-        return static_cast<class_instance_conversion<T>&>(*this).construct(std::forward<Args>(args)...);
+    template <typename Allocator> void reset(Allocator& allocator) {
+        (static_cast<class_instance_conversion<Owner, Types>&>(*this).reset(
+             allocator),
+         ...);
     }
 
-    void reset() {
-        (static_cast<class_instance_conversion<Types>&>(*this).reset(), ...);
+    std::size_t memory_usage() const {
+        return (std::size_t(0) + ... +
+                static_cast<const class_instance_conversion<Owner, Types>&>(
+                    *this)
+                    .memory_usage());
     }
 };
 
@@ -63,8 +134,8 @@ template< typename... Types > struct class_instance_conversions
 // context-owned instances. That would require pushing and popping of
 // the context on each resolution. Right now, conversions are like
 // "expanded variant".
-template< typename... Args > struct class_instance_conversions< type_list<Args...> >
-: class_instance_conversions<Args...>
+template< typename Owner, typename... Args > struct class_instance_conversions< Owner, type_list<Args...> >
+: class_instance_conversions<Owner, Args...>
 {}; 
 
 } // namespace dingo
@@ -9,35 +9,73 @@
 
 #include <dingo/config.h>
 
+#include <dingo/class_instance_container.h>
 #include <dingo/class_instance_factory_i.h>
 #include <dingo/class_instance_resolver.h>
+#include <dingo/observer.h>
 #include <dingo/rebind_type.h>
 #include <dingo/resolving_context.h>
+#include <dingo/type_graph.h>
+#include <dingo/validation.h>
 
 namespace dingo {
+template <typename RTTI, typename... Types>
+bool contains_type_index(type_list<Types...>,
+                         const typename RTTI::type_index& type) {
+    return ((RTTI::template get_type_index<Types>() == type) || ...);
+}
+
 // TODO: this is bit convoluted, ideally merge resolver with factory
 
 template <typename Container, typename Storage> struct class_instance_factory_data {
   public:
-    using container_type = Container;
+    using container_type = class_instance_container<Container>;
 
     template <typename ParentContainer, typename... Args>
     class_instance_factory_data(ParentContainer* parent, Args&&... args)
-        : storage(std::forward<Args>(args)...),
-          container(parent, parent->get_allocator()) {}
+        : storage(std::forward<Args>(args)...), container(parent) {}
 
     Storage storage;
-    Container container;
+    container_type container;
 };
 
 template <typename T> struct class_instance_factory_data_traits {
     using container_type = typename T::container_type;
     static T& get_data(T& data) { return data; }
+    static bool is_last_owner(T&) { return true; }
+    static std::size_t get_layout_size(T&, std::size_t size) { return size; }
+
+    static void get_memory_usage(T& data, container_memory_usage& usage) {
+        usage.storages += sizeof(data.storage);
+        usage.factories += sizeof(T) - sizeof(data.storage);
+        data.container.get_memory_usage(usage);
+    }
 };
 
 template <typename T> struct class_instance_factory_data_traits<std::shared_ptr<T>> {
     using container_type = typename T::container_type;
     static T& get_data(std::shared_ptr<T>& data) { return *data; }
+    static bool is_last_owner(std::shared_ptr<T>& data) {
+        return data.use_count() == 1;
+    }
+
+    // Storage shared by factories of a multi-interface registration is
+    // reserved once, each factory reports its part rounded up
+    static std::size_t get_layout_size(std::shared_ptr<T>& data,
+                                       std::size_t size) {
+        auto owners = static_cast<std::size_t>(data.use_count());
+        return (size + owners - 1) / owners;
+    }
+
+    // Data shared by factories of a multi-interface registration is split
+    // evenly between them
+    static void get_memory_usage(std::shared_ptr<T>& data,
+                                 container_memory_usage& usage) {
+        container_memory_usage shared;
+        class_instance_factory_data_traits<T>::get_memory_usage(*data, shared);
+        usage.factories += sizeof(data);
+        usage += shared / static_cast<std::size_t>(data.use_count());
+    }
 };
 
 template <typename RTTI, typename Factory, typename Context>
@@ -61,27 +99,95 @@ void* resolve_address(Factory& factory, Context& context,
     }
 }
 
+// Overrides of class_instance_factory_diagnostics_i forwarding to Factory,
+// present only for containers with diagnostics
+template <typename Container, typename Factory,
+          bool Enabled = is_diagnostics_enabled<
+              typename Container::container_traits_type>::value>
+class class_instance_factory_diagnostics
+    : public class_instance_factory_i<Container> {};
+
+template <typename Container, typename Factory>
+class class_instance_factory_diagnostics<Container, Factory, true>
+    : public class_instance_factory_i<Container> {
+  public:
+    bool is_convertible(
+        instance_category category,
+        const typename Container::rtti_type::type_index& type) override {
+        return factory().convertible(category, type);
+    }
+
+    void get_memory_usage(container_memory_usage& usage) override {
+        factory().add_memory_usage(usage);
+    }
+
+    void get_graph(type_graph_builder<typename Container::rtti_type>& builder,
+                   std::size_t container, bool indexed) override {
+        factory().add_graph(builder, container, indexed);
+    }
+
+    void validate(type_validation& validation) override {
+        factory().validate_dependencies(validation);
+    }
+
+  private:
+    Factory& factory() { return static_cast<Factory&>(*this); }
+};
+
 // TODO: the container here is just for RTTI, but it is needed to get the
 // inner container type and that is very hard. Perhaps pass RTTI and inner
 // container directly?
 template <typename Container, typename Type, typename Storage,
           typename Data>
-class class_instance_factory : public class_instance_factory_i<Container> {
+class class_instance_factory
+    : public class_instance_factory_diagnostics<
+          Container, class_instance_factory<Container, Type, Storage, Data>> {
+    friend class class_instance_factory_diagnostics<
+        Container, class_instance_factory<Container, Type, Storage, Data>>;
+
   public:
     using storage_type = Storage;
     using container_type = typename class_instance_factory_data_traits<Data>::container_type;
 
   private:
+    using rtti_type = typename Container::rtti_type;
+    using observer_type = typename Container::observer_type;
+    using stored_type = decay_t<typename Storage::type>;
+
     Data data_;
-    class_instance_resolver<typename Container::rtti_type, Type, Storage> resolver_;
+    class_instance_resolver<rtti_type, Type, Storage> resolver_;
 
     auto& get_storage() { return class_instance_factory_data_traits<Data>::get_data(data_).storage; }
 
+    // Returns true if the storage keeps an already constructed instance.
+    // Storages without is_resolved() construct on each resolution.
+    template <typename StorageT = Storage>
+    auto has_instance(int) -> decltype(std::declval<StorageT&>().is_resolved()) {
+        return get_storage().is_resolved();
+    }
+    bool has_instance(...) { return false; }
+
+    static auto get_scope_index() {
+        return rtti_type::template get_type_index<typename Storage::tag_type>();
+    }
+
   public:
     template <typename... Args>
     class_instance_factory(Args&&... args)
         : data_(std::forward<Args>(args)...) {}
 
+    ~class_instance_factory() {
+        resolver_.destroy(get_container());
+        if constexpr (is_observer_enabled_v<observer_type> &&
+                      !std::is_same_v<typename Storage::tag_type, external>) {
+            if (class_instance_factory_data_traits<Data>::is_last_owner(data_) &&
+                has_instance(0))
+                observer_type::on_destroy(
+                    rtti_type::template get_type_index<stored_type>(),
+                    get_scope_index());
+        }
+    }
+
     auto& get_container() { return class_instance_factory_data_traits<Data>::get_data(data_).container; }
     
     void*
@@ -127,8 +233,37 @@ class class_instance_factory : public class_instance_factory_i<Container> {
         using Target = std::remove_reference_t<rebind_type_t<T, Type>>;
         using Source = decltype(resolve(context));
 
-        return resolver_.template resolve_address<Target, Source>(context,
-            get_container(), get_storage(), *this);
+        if constexpr (is_observer_enabled_v<observer_type>) {
+            observer_type::on_factory_invoke(
+                rtti_type::template get_type_index<Type>(), get_scope_index());
+#if DINGO_ARENA_STATISTICS
+            std::size_t temporaries = context.temporaries();
+#endif
+            void* ptr = nullptr;
+            if (has_instance(0)) {
+                ptr = resolver_.template resolve_address<Target, Source>(
+                    context, get_container(), get_storage(), *this);
+            } else {
+                construct_observer_guard<observer_type, rtti_type, stored_type,
+                                         typename Storage::tag_type>
+                    guard;
+                ptr = resolver_.template resolve_address<Target, Source>(
+                    context, get_container(), get_storage(), *this);
+                observer_type::on_construct(
+                    rtti_type::template get_type_index<stored_type>(),
+                    get_scope_index());
+            }
+#if DINGO_ARENA_STATISTICS
+            if (context.temporaries() != temporaries)
+                observer_type::on_temporaries(
+                    rtti_type::template get_type_index<Type>(),
+                    context.temporaries() - temporaries);
+#endif
+            return ptr;
+        } else {
+            return resolver_.template resolve_address<Target, Source>(
+                context, get_container(), get_storage(), *this);
+        }
     }
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -143,7 +278,42 @@ class class_instance_factory : public class_instance_factory_i<Container> {
         if constexpr (std::is_same_v<T, Source >)
             return resolve(context);
         else
-            return resolver_.template construct_conversion<T>(context, resolve(context));
+            return resolver_.template construct_conversion<T>(
+                context, get_container(), resolve(context));
+    }
+
+    // Instances that were already resolved need no space
+    std::size_t get_layout_size() override {
+        if constexpr (std::is_same_v<typename Storage::tag_type, shared>) {
+            if (has_instance(0))
+                return 0;
+            return class_instance_factory_data_traits<Data>::get_layout_size(
+                data_, get_storage().layout_size());
+        } else {
+            return 0;
+        }
+    }
+
+    // Constructs shared instance that was not resolved yet
+    void finalize(resolving_context& context) override {
+        if constexpr (std::is_same_v<typename Storage::tag_type, shared>) {
+            if constexpr (is_observer_enabled_v<observer_type>) {
+                if (!has_instance(0)) {
+                    construct_observer_guard<observer_type, rtti_type,
+                                             stored_type, shared>
+                        guard;
+                    resolver_.construct(context, get_container(),
+                                        get_storage());
+                    observer_type::on_construct(
+                        rtti_type::template get_type_index<stored_type>(),
+                        get_scope_index());
+                }
+            } else {
+                resolver_.construct(context, get_container(), get_storage());
+            }
+        } else {
+            (void)context;
+        }
     }
 
     void destroy() override {
@@ -152,6 +322,83 @@ class class_instance_factory : public class_instance_factory_i<Container> {
         allocator_traits::destroy(allocator, this);
         allocator_traits::deallocate(allocator, this, 1);
     }
+
+  private:
+    // Diagnostics, see class_instance_factory_diagnostics
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4702)
+#endif
+    bool convertible(instance_category category,
+                     const typename rtti_type::type_index& type) {
+        using conversions = typename Storage::conversions;
+        switch (category) {
+        case instance_category::value:
+            return contains_type_index<rtti_type>(
+                typename conversions::value_types{}, type);
+        case instance_category::lvalue_reference:
+            return contains_type_index<rtti_type>(
+                typename conversions::lvalue_reference_types{}, type);
+        case instance_category::rvalue_reference:
+            return contains_type_index<rtti_type>(
+                typename conversions::rvalue_reference_types{}, type);
+        case instance_category::pointer:
+            return contains_type_index<rtti_type>(
+                typename conversions::pointer_types{}, type);
+        }
+        return false;
+    }
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+    void add_memory_usage(container_memory_usage& usage) {
+        usage.factories +=
+            sizeof(*this) - sizeof(Data) - sizeof(resolver_);
+        usage.conversions += sizeof(resolver_);
+        resolver_.get_memory_usage(usage);
+        class_instance_factory_data_traits<Data>::get_memory_usage(data_,
+                                                                   usage);
+    }
+
+    void add_graph(type_graph_builder<rtti_type>& builder,
+                   std::size_t container, bool indexed) {
+        using factory_traits =
+            factory_graph_traits<typename detail::storage_factory<Storage>::type>;
+
+        type_graph::node node;
+        node.interface = type_name<Type>();
+        node.storage = type_name<typename Storage::type>();
+        node.scope = type_name<typename Storage::tag_type>();
+        node.container = container;
+        node.arity = factory_traits::arity();
+        node.indexed = indexed;
+
+        factory_traits::for_each_argument([&](auto element) {
+            builder.graph.add_edge(
+                node.interface,
+                std::string(type_name<typename decltype(element)::type>()),
+                false);
+        });
+        builder.names.emplace(rtti_type::template get_type_index<Type>(),
+                              node.interface);
+        builder.graph.nodes.push_back(std::move(node));
+
+        auto nested = get_container().find();
+        if (nested && builder.visit(nested))
+            nested->get_graph(builder, builder.graph.nodes.size() - 1,
+                              container);
+    }
+
+    void validate_dependencies(type_validation& validation) {
+        validation.set_registration(type_name<Type>());
+        factory_dependencies<typename detail::storage_factory<Storage>::type>::
+            validate(get_container(), validation);
+
+        auto nested = get_container().find();
+        if (nested)
+            nested->validate(validation);
+    }
 };
 
 // This is much faster than unique_ptr + deleter
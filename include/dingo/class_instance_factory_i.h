@@ -9,10 +9,57 @@
 
 #include <dingo/config.h>
 
+#include <dingo/diagnostics.h>
+#include <dingo/memory_usage.h>
+
+#include <cstddef>
+
 namespace dingo {
 class resolving_context;
+class type_validation;
+template <typename RTTI> struct type_graph_builder;
+
+// Value categories of instances provided by the factory, see
+// class_instance_factory_traits
+enum class instance_category {
+    value,
+    lvalue_reference,
+    rvalue_reference,
+    pointer
+};
 
-template <typename Container> class class_instance_factory_i {
+// Diagnostics of a registration, declared only for containers with
+// diagnostics enabled, see is_diagnostics_enabled
+template <typename Container, bool Enabled>
+class class_instance_factory_diagnostics_i {};
+
+template <typename Container>
+class class_instance_factory_diagnostics_i<Container, true> {
+  public:
+    virtual ~class_instance_factory_diagnostics_i() = default;
+
+    // Returns true if the factory provides type in the category, so
+    // the matching get_...() function does not throw
+    virtual bool
+    is_convertible(instance_category,
+                   const typename Container::rtti_type::type_index&) = 0;
+
+    virtual void get_memory_usage(container_memory_usage&) = 0;
+
+    // Adds the registration to the graph, see container::graph()
+    virtual void
+    get_graph(type_graph_builder<typename Container::rtti_type>& builder,
+              std::size_t container, bool indexed) = 0;
+
+    // Validates dependencies of the registration, see container::validate()
+    virtual void validate(type_validation&) = 0;
+};
+
+template <typename Container>
+class class_instance_factory_i
+    : public class_instance_factory_diagnostics_i<
+          Container, is_diagnostics_enabled<
+                         typename Container::container_traits_type>::value> {
   public:
     virtual ~class_instance_factory_i() = default;
 
@@ -29,6 +76,10 @@ template <typename Container> class class_instance_factory_i {
     get_pointer(resolving_context&,
                 const typename Container::rtti_type::type_index&) = 0;
 
+    // Bytes the instance needs in a shared region, see container::finalize()
+    virtual std::size_t get_layout_size() = 0;
+    virtual void finalize(resolving_context&) = 0;
+
     virtual void destroy() = 0;
 
     bool cacheable = false; // TODO
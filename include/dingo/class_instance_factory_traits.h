@@ -8,6 +8,7 @@
 #pragma once
 
 #include <dingo/config.h>
+#include <dingo/class_instance_factory_i.h>
 #include <dingo/type_traits.h>
 
 #include <memory>
@@ -47,6 +48,12 @@ template <typename RTTI, typename T> struct class_instance_factory_traits {
             context,
             RTTI::template get_type_index<rebind_type_t<T, runtime_type>>());
     }
+
+    template <typename Factory> static bool is_convertible(Factory& factory) {
+        return factory.is_convertible(
+            instance_category::value,
+            RTTI::template get_type_index<rebind_type_t<T, runtime_type>>());
+    }
 };
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -62,6 +69,12 @@ struct class_instance_factory_traits<RTTI, T&> {
             context,
             RTTI::template get_type_index<rebind_type_t<T&, runtime_type>>());
     }
+
+    template <typename Factory> static bool is_convertible(Factory& factory) {
+        return factory.is_convertible(
+            instance_category::lvalue_reference,
+            RTTI::template get_type_index<rebind_type_t<T&, runtime_type>>());
+    }
 };
 
 template <typename RTTI, typename T>
@@ -74,6 +87,12 @@ struct class_instance_factory_traits<RTTI, const T&> {
             context,
             RTTI::template get_type_index<rebind_type_t<T&, runtime_type>>());
     }
+
+    template <typename Factory> static bool is_convertible(Factory& factory) {
+        return factory.is_convertible(
+            instance_category::lvalue_reference,
+            RTTI::template get_type_index<rebind_type_t<T&, runtime_type>>());
+    }
 };
 
 template <typename RTTI, typename T>
@@ -86,6 +105,12 @@ struct class_instance_factory_traits<RTTI, T&&> {
             context,
             RTTI::template get_type_index<rebind_type_t<T&&, runtime_type>>());
     }
+
+    template <typename Factory> static bool is_convertible(Factory& factory) {
+        return factory.is_convertible(
+            instance_category::rvalue_reference,
+            RTTI::template get_type_index<rebind_type_t<T&&, runtime_type>>());
+    }
 };
 
 template <typename RTTI, typename T>
@@ -98,6 +123,12 @@ struct class_instance_factory_traits<RTTI, T*> {
             context,
             RTTI::template get_type_index<rebind_type_t<T*, runtime_type>>());
     }
+
+    template <typename Factory> static bool is_convertible(Factory& factory) {
+        return factory.is_convertible(
+            instance_category::pointer,
+            RTTI::template get_type_index<rebind_type_t<T*, runtime_type>>());
+    }
 };
 
 } // namespace dingo
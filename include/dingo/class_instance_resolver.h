@@ -9,12 +9,17 @@
 
 #include <dingo/config.h>
 
+#include <dingo/allocator.h>
 #include <dingo/class_instance_conversions.h>
 #include <dingo/decay.h>
 #include <dingo/exceptions.h>
+#include <dingo/memory_usage.h>
 #include <dingo/resolving_context.h>
 #include <dingo/type_conversion.h>
 
+#include <memory>
+#include <new>
+
 namespace dingo {
 
 struct unique;
@@ -77,17 +82,24 @@ struct class_instance_resolver<RTTI, Type, Storage, unique> {
         return ::dingo::get_address(context, std::forward<decltype(instance)>(instance));
     }
 
+    void get_memory_usage(container_memory_usage&) const {}
+
+    template <typename Container> void destroy(Container&) {}
+
 private:
-    template <typename T, typename Context, typename... Args> T& construct_conversion(Context& context, Args&&... args) {
+    template <typename T, typename Context, typename Container, typename... Args>
+    T& construct_conversion(Context& context, Container&, Args&&... args) {
         return context.template construct<T>(std::forward<Args>(args)...);
     }
 };
 
 template <typename RTTI, typename Type, typename Storage>
 struct class_instance_resolver<RTTI, Type, Storage, shared>
-    : class_instance_conversions< rebind_type_t< typename Storage::conversions::conversion_types, Type > >
+    : class_instance_conversions< class_instance_resolver<RTTI, Type, Storage, shared>,
+        rebind_type_t< typename Storage::conversions::conversion_types, Type > >
 {
     using class_instance_conversions_type = class_instance_conversions<
+        class_instance_resolver,
         rebind_type_t<typename Storage::conversions::conversion_types, Type>>;
 
     template <typename Context, typename Container>
@@ -109,8 +121,9 @@ struct class_instance_resolver<RTTI, Type, Storage, shared>
             // Closure is used to construct temporary. If we get to push, it means there was no exception,
             // closure is popped and that will preserve it, as only closures left on stack will get destroyed
             // by resolving_context. That is why there is no scope guard.
-
-            context.push(&closure_);
+            // Closure is allocated only for the construction and released
+            // afterwards if nothing was placed into it.
+            context.push(&acquire_closure(container));
             storage.resolve(context, container);
 
             auto&& instance =
@@ -119,6 +132,7 @@ struct class_instance_resolver<RTTI, Type, Storage, shared>
 
             void* p = ::dingo::get_address(context, std::forward<decltype(instance)>(instance));
             context.pop();
+            release_closure(container);
             return p;
         }
 
@@ -128,20 +142,78 @@ struct class_instance_resolver<RTTI, Type, Storage, shared>
         return ::dingo::get_address(context, std::forward<decltype(instance)>(instance));
     }
 
-    template <typename T, typename Context, typename... Args> T& construct_conversion(Context& context, Args&&... args) {
-        (void)context;
-        return conversions().template construct<T>(std::forward<Args>(args)...);
+    // Constructs the instance without converting it, see container::finalize()
+    template <typename Context, typename Container>
+    void construct(Context& context, Container& container, Storage& storage) {
+        if (initialized_ || storage.is_resolved())
+            return;
+
+        [[maybe_unused]] class_recursion_guard<
+            decay_t<typename Storage::type>> recursion_guard;
+
+        context.push(&acquire_closure(container));
+        storage.resolve(context, container);
+        context.pop();
+        release_closure(container);
+    }
+
+    template <typename T, typename Context, typename Container, typename... Args>
+    T& construct_conversion(Context&, Container& container, Args&&... args) {
+        return conversions().template construct<T>(
+            container.get_allocator(), std::forward<Args>(args)...);
+    }
+
+    void get_memory_usage(container_memory_usage& usage) const {
+        usage.conversions += class_instance_conversions_type::memory_usage();
+        if (closure_)
+            usage.closures += sizeof(*closure_) + closure_->size();
+    }
+
+    // Releases the closure and conversions, the container must be the one
+    // passed to resolve_address()
+    template <typename Container> void destroy(Container& container) {
+        conversions().reset(container.get_allocator());
+        release_closure(container, true);
     }
 
   private:
+    using closure_type =
+        resolving_context::owned_closure<class_instance_resolver>;
+
     auto& conversions() {
         return static_cast<class_instance_conversions_type&>(*this);
     }
 
+    template <typename Container>
+    resolving_context::closure& acquire_closure(Container& container) {
+        if (!closure_) {
+            auto alloc =
+                allocator_traits::rebind<closure_type>(container.get_allocator());
+            closure_type* closure = allocator_traits::allocate(alloc, 1);
+            if (!closure)
+                throw std::bad_alloc();
+            allocator_traits::construct(alloc, closure,
+                                        container.get_arena_upstream());
+            closure_ = closure;
+        }
+        return *closure_;
+    }
+
+    // Closure is released if nothing was placed into it, unless forced
+    template <typename Container>
+    void release_closure(Container& container, bool force = false) {
+        if (closure_ && (force || closure_->empty())) {
+            auto alloc =
+                allocator_traits::rebind<closure_type>(container.get_allocator());
+            allocator_traits::destroy(alloc, closure_);
+            allocator_traits::deallocate(alloc, closure_, 1);
+            closure_ = nullptr;
+        }
+    }
+
     bool initialized_ = false;
 
-    // TODO: closure is not needed for default constructible types
-    resolving_context::closure closure_;
+    closure_type* closure_ = nullptr;
 };
 
 template <typename RTTI, typename Type, typename Storage>
@@ -150,10 +222,11 @@ struct class_instance_resolver<RTTI, Type, Storage, shared_cyclical>
 
 template <typename RTTI, typename Type, typename Storage>
 struct class_instance_resolver<RTTI, Type, Storage, external>
-    : class_instance_conversions< rebind_type_t<typename Storage::conversions::conversion_types,
-                              Type>>
+    : class_instance_conversions< class_instance_resolver<RTTI, Type, Storage, external>,
+        rebind_type_t<typename Storage::conversions::conversion_types, Type>>
 {
     using class_instance_conversions_type = class_instance_conversions<
+        class_instance_resolver,
         rebind_type_t<typename Storage::conversions::conversion_types,
                             Type>>;
 
@@ -176,9 +249,20 @@ struct class_instance_resolver<RTTI, Type, Storage, external>
         return ::dingo::get_address(context, std::forward<decltype(instance)>(instance));
     }
 
-    template <typename T, typename Context, typename... Args> T& construct_conversion(Context& context, Args&&... args) {
-        (void)context;
-        return conversions().template construct<T>(std::forward<Args>(args)...);
+    template <typename T, typename Context, typename Container, typename... Args>
+    T& construct_conversion(Context&, Container& container, Args&&... args) {
+        return conversions().template construct<T>(
+            container.get_allocator(), std::forward<Args>(args)...);
+    }
+
+    void get_memory_usage(container_memory_usage& usage) const {
+        usage.conversions += class_instance_conversions_type::memory_usage();
+    }
+
+    // Releases conversions, the container must be the one passed to
+    // resolve_address()
+    template <typename Container> void destroy(Container& container) {
+        conversions().reset(container.get_allocator());
     }
 #ifdef _MSC_VER
 #pragma warning(pop)
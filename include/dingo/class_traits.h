@@ -9,6 +9,8 @@
 
 #include <dingo/config.h>
 
+#include <dingo/arena_allocator.h>
+
 #include <memory>
 #include <optional>
 #include <type_traits>
@@ -71,6 +73,18 @@ template <typename T> struct class_traits<std::shared_ptr<T>> {
     static void construct(void* ptr, Args&&... args) {
         new (ptr) std::shared_ptr<T>{new T{std::forward<Args>(args)...}};
     }
+
+    // Allocates the instance and the control block through the allocator
+    template <typename Allocator, typename... Args>
+    static std::shared_ptr<T> allocate(const Allocator& allocator,
+                                       Args&&... args) {
+        if constexpr (std::is_constructible_v<T, Args...>)
+            return std::allocate_shared<T>(allocator,
+                                           std::forward<Args>(args)...);
+        else
+            return std::allocate_shared<T>(allocator,
+                                           T{std::forward<Args>(args)...});
+    }
 };
 
 template <typename T> struct class_traits<std::optional<T>> {
@@ -100,4 +114,23 @@ template <typename T> struct class_traits<std::optional<T>> {
     }
 };
 
+// Types whose class_traits can allocate through an allocator
+template <typename T> struct is_class_allocatable : std::false_type {};
+template <typename T>
+struct is_class_allocatable<std::shared_ptr<T>> : std::true_type {};
+
+// Constructs Type, allocating it from the instance arena of the context if
+// there is one (see container::resolve_into())
+template <typename Type, typename Context, typename... Args>
+Type construct_class(Context& context, Args&&... args) {
+    if constexpr (is_class_allocatable<Type>::value) {
+        if (auto arena = context.get_instance_arena())
+            return class_traits<Type>::allocate(arena_allocator<void>(*arena),
+                                                std::forward<Args>(args)...);
+    } else {
+        (void)context;
+    }
+    return class_traits<Type>::construct(std::forward<Args>(args)...);
+}
+
 } // namespace dingo
@@ -19,6 +19,38 @@
 #define DINGO_CONTEXT_ARENA_BUFFER_SIZE 128
 #endif
 
+#if !defined(DINGO_ARENA_STATISTICS)
+#define DINGO_ARENA_STATISTICS 0
+#endif
+
+#if !defined(DINGO_ARENA_BLOCK_CACHE_SIZE)
+#define DINGO_ARENA_BLOCK_CACHE_SIZE 4
+#endif
+
+#if !defined(DINGO_ARENA_BLOCK_CACHE_MAX_BLOCK_SIZE)
+#define DINGO_ARENA_BLOCK_CACHE_MAX_BLOCK_SIZE (1 << 16)
+#endif
+
+#if !defined(DINGO_CACHE_LINE_SIZE)
+#define DINGO_CACHE_LINE_SIZE 64
+#endif
+
+#if !defined(DINGO_COUNTERS_SHARDS)
+#define DINGO_COUNTERS_SHARDS 8
+#endif
+
+#if !defined(DINGO_DISPATCH_TABLE_MIN_SIZE)
+#define DINGO_DISPATCH_TABLE_MIN_SIZE 256
+#endif
+
+#if !defined(DINGO_DISPATCH_TABLE_MAX_SPARSITY)
+#define DINGO_DISPATCH_TABLE_MAX_SPARSITY 16
+#endif
+
+#if !defined(DINGO_POOLED_STORAGE_CAPACITY)
+#define DINGO_POOLED_STORAGE_CAPACITY 8
+#endif
+
 #if __cplusplus > 202002L || (defined(_MSVC_LANG) && _MSVC_LANG > 202002L)
 #define DINGO_CXX_STANDARD 23
 #elif (__cplusplus > 201703L && __cplusplus <= 202002L) || (defined(_MSVC_LANG) && _MSVC_LANG == 202002L)
@@ -14,20 +14,27 @@
 #include <dingo/class_instance_factory.h>
 #include <dingo/class_instance_factory_traits.h>
 #include <dingo/collection_traits.h>
+#include <dingo/counters.h>
 #include <dingo/decay.h>
+#include <dingo/diagnostics.h>
 #include <dingo/exceptions.h>
 #include <dingo/factory/callable.h>
 #include <dingo/factory/invoke.h>
 #include <dingo/index.h>
+#include <dingo/memory_usage.h>
+#include <dingo/observer.h>
 #include <dingo/resolving_context.h>
 #include <dingo/rtti/static_provider.h>
 #include <dingo/rtti/typeid_provider.h>
 #include <dingo/static_allocator.h>
 #include <dingo/storage/unique.h> // TODO
 #include <dingo/type_cache.h>
+#include <dingo/type_graph.h>
 #include <dingo/type_map.h>
 #include <dingo/type_registration.h>
+#include <dingo/value_copy.h>
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <optional>
@@ -41,6 +48,8 @@ template <typename T> struct is_none : std::bool_constant<false> {};
 template <> struct is_none<none_t> : std::bool_constant<true> {};
 template <typename T> static constexpr auto is_none_v = is_none<T>::value;
 
+template <typename T, typename Key, typename Container> class dispatch_table;
+
 struct dynamic_container_traits {
     template <typename> using rebind_t = dynamic_container_traits;
 
@@ -53,6 +62,7 @@ struct dynamic_container_traits {
     using allocator_type = std::allocator<char>;
     using index_definition_type = std::tuple<>;
     static constexpr bool cache_enabled = true;
+    static constexpr bool adaptive_arena_enabled = false;
 };
 
 template <typename Tag = void> struct static_container_traits {
@@ -67,6 +77,113 @@ template <typename Tag = void> struct static_container_traits {
     using allocator_type = static_allocator<char, Tag>;
     using index_definition_type = std::tuple<>;
     static constexpr bool cache_enabled = true;
+    static constexpr bool adaptive_arena_enabled = false;
+};
+
+// Containers with adaptive arena remember how many bytes of temporaries were
+// needed to resolve a type and reserve the resolving_context arena for them.
+template <typename Traits, typename = void>
+struct is_adaptive_arena_enabled : std::bool_constant<false> {};
+
+template <typename Traits>
+struct is_adaptive_arena_enabled<
+    Traits, std::void_t<decltype(Traits::adaptive_arena_enabled)>>
+    : std::bool_constant<Traits::adaptive_arena_enabled> {};
+
+// Containers with arena upstream request arena blocks of resolving contexts
+// and closures from the container allocator instead of the heap and the
+// thread-local block cache. Contexts are short-lived, so this suits allocators
+// that reuse deallocated memory (eg. std::pmr::synchronized_pool_resource);
+// allocators that never release memory, like arena_allocator or
+// std::pmr::monotonic_buffer_resource, grow with each spilling resolution.
+template <typename Traits, typename = void>
+struct is_arena_upstream_enabled : std::bool_constant<false> {};
+
+template <typename Traits>
+struct is_arena_upstream_enabled<
+    Traits, std::void_t<decltype(Traits::arena_upstream_enabled)>>
+    : std::bool_constant<Traits::arena_upstream_enabled> {};
+
+// Allocator base of the container owning the regions shared instances are
+// placed into by container::finalize(). Being a base, the regions are released
+// after the factories have destroyed the instances. Static allocators allocate
+// single objects only, so static containers do not use regions.
+template <typename Allocator>
+class container_shared_regions : public allocator_base<Allocator> {
+  public:
+    template <typename AllocatorT>
+    container_shared_regions(AllocatorT&& alloc)
+        : allocator_base<Allocator>(std::forward<AllocatorT>(alloc)) {}
+
+    container_shared_regions(const container_shared_regions&) = delete;
+    container_shared_regions&
+    operator=(const container_shared_regions&) = delete;
+
+    ~container_shared_regions() {
+        if constexpr (is_array_allocator<Allocator>::value) {
+            while (shared_regions_) {
+                shared_region* next = shared_regions_->next;
+                get_region_upstream().deallocate(shared_regions_,
+                                                 shared_regions_->size);
+                shared_regions_ = next;
+            }
+        }
+    }
+
+  protected:
+    // Returns a new region for size bytes of instances of owner
+    shared_region* allocate_shared_region(std::size_t size, const void* owner) {
+        constexpr std::size_t alignment = arena_upstream::alignment;
+        size = (sizeof(shared_region) + size + alignment - 1) & ~(alignment - 1);
+        void* ptr = get_region_upstream().allocate(size);
+        if (!ptr)
+            throw std::bad_alloc();
+        shared_regions_ = new (ptr) shared_region(size, shared_regions_, owner);
+        return shared_regions_;
+    }
+
+    std::size_t shared_regions_size() const {
+        std::size_t size = 0;
+        for (auto region = shared_regions_; region; region = region->next)
+            size += region->size;
+        return size;
+    }
+
+  private:
+    arena_upstream get_region_upstream() {
+        static_assert(is_array_allocator<Allocator>::value);
+        return arena_upstream::make(this->get_allocator());
+    }
+
+    shared_region* shared_regions_ = nullptr;
+};
+
+// Largest amount of temporaries observed resolving a registered type, kept
+// per container by containers with adaptive arena
+template <bool Enabled> struct type_arena_size {
+    std::size_t get_arena_size() const { return 0; }
+    void update_arena_size(std::size_t) {}
+};
+
+template <> struct type_arena_size<true> {
+    type_arena_size() = default;
+    type_arena_size(const type_arena_size& other)
+        : arena_size_(other.get_arena_size()) {}
+
+    std::size_t get_arena_size() const {
+        return arena_size_.load(std::memory_order_relaxed);
+    }
+
+    void update_arena_size(std::size_t size) {
+        std::size_t current = arena_size_.load(std::memory_order_relaxed);
+        while (current < size &&
+               !arena_size_.compare_exchange_weak(current, size,
+                                                  std::memory_order_relaxed))
+            ;
+    }
+
+  private:
+    std::atomic<std::size_t> arena_size_{0};
 };
 
 // TODO: could this use is_none_v?
@@ -80,11 +197,22 @@ static constexpr bool is_tagged_container_v =
 template <typename ContainerTraits = dynamic_container_traits,
           typename Allocator = typename ContainerTraits::allocator_type,
           typename ParentContainer = void>
-class container : public allocator_base<Allocator> {
+class container
+    : public container_shared_regions<Allocator>,
+      public value_copy_counter<container_value_copy_policy_t<ContainerTraits>>,
+      public container_counter<is_counters_enabled<ContainerTraits>::value,
+                               counters_shards<ContainerTraits>::value> {
     friend class resolving_context;
     template <typename ContainerTraitsT, typename AllocatorT,
               typename ParentContainerT>
     friend class container;
+    template <typename T, typename Key, typename ContainerT>
+    friend class dispatch_table;
+    template <typename ContainerT> friend class class_instance_container;
+    friend struct detail::dependency_validator;
+    template <typename ContainerT, typename TypeT, typename StorageT,
+              typename DataT>
+    friend class class_instance_factory;
 
     template <typename ContainerTraitsT, typename AllocatorT,
               typename ParentContainerT>
@@ -96,6 +224,17 @@ class container : public allocator_base<Allocator> {
                            container_type, ParentContainer>;
 
     static constexpr bool cache_enabled = ContainerTraits::cache_enabled;
+    static constexpr bool adaptive_arena_enabled =
+        is_adaptive_arena_enabled<ContainerTraits>::value;
+    static constexpr bool counters_enabled =
+        is_counters_enabled<ContainerTraits>::value;
+    static constexpr bool arena_upstream_enabled =
+        is_arena_upstream_enabled<ContainerTraits>::value;
+    static constexpr bool diagnostics_enabled =
+        is_diagnostics_enabled<ContainerTraits>::value;
+    using counter_type =
+        container_counter<counters_enabled,
+                          counters_shards<ContainerTraits>::value>;
 
   public:
     using container_traits_type = ContainerTraits;
@@ -103,6 +242,7 @@ class container : public allocator_base<Allocator> {
     using rtti_type = typename ContainerTraits::rtti_type;
     using index_definition_type =
         typename ContainerTraits::index_definition_type;
+    using observer_type = container_observer_t<ContainerTraits>;
 
     template <typename Tag>
     using child_container_type =
@@ -111,16 +251,20 @@ class container : public allocator_base<Allocator> {
                   Allocator, container_type>;
 
     container()
-        : allocator_base<allocator_type>(allocator_type()),
+        : container_shared_regions<allocator_type>(allocator_type()),
           type_factories_(get_allocator()), type_cache_(get_allocator()) {}
 
     container(allocator_type alloc)
-        : allocator_base<allocator_type>(alloc),
+        : container_shared_regions<allocator_type>(alloc),
           type_factories_(get_allocator()), type_cache_(get_allocator()) {}
 
-    container(parent_container_type* parent,
-              allocator_type alloc = allocator_type())
-        : allocator_base<allocator_type>(alloc), parent_(parent),
+    // Child containers share the allocator of the parent container when the
+    // allocator types are compatible
+    container(parent_container_type* parent)
+        : container(parent, get_parent_allocator(parent)) {}
+
+    container(parent_container_type* parent, allocator_type alloc)
+        : container_shared_regions<allocator_type>(alloc), parent_(parent),
           type_factories_(get_allocator()), type_cache_(get_allocator()) {
 
         static_assert(
@@ -176,48 +320,155 @@ class container : public allocator_base<Allocator> {
             });
     }
 
+    // Estimates the number of bytes a registration allocates from the container
+    // allocator for its factories and storage. Summed over all registrations,
+    // the estimate can be used to size an arena_allocator so registrations are
+    // laid out contiguously.
+    template <typename... TypeArgs>
+    static constexpr std::size_t registration_size() {
+        return registration_types<type_registration<TypeArgs...>>::size();
+    }
+
     template <typename T, typename IdType = none_t,
               typename R = typename annotated_traits<
                   std::conditional_t<std::is_rvalue_reference_v<T>,
                                      std::remove_reference_t<T>, T>>::type>
     R resolve(IdType&& id = IdType()) {
-        // TODO: a crude way to check cache before context gets placed on the
-        // stack
-        if constexpr (cache_enabled) {
-            if constexpr (is_none_v<std::decay_t<IdType>>) {
-                void* cache = type_cache_.template get<T>();
-                if (cache) {
-                    return class_instance_factory_traits<
-                        rtti_type,
-                        typename annotated_traits<T>::type>::convert(cache);
-                }
-            } else {
-                auto data = type_factories_.template get<decay_t<T>>();
-                if (data) {
-                    auto indexed =
-                        data->template get_index<IdType>(get_allocator())
-                            .find(id);
+        if constexpr (counters_enabled) {
+            this->on_resolve();
+            try {
+                return resolve_root<T, IdType, R>(std::forward<IdType>(id));
+            } catch (...) {
+                this->on_exception();
+                throw;
+            }
+        } else {
+            return resolve_root<T, IdType, R>(std::forward<IdType>(id));
+        }
+    }
 
-                    if (indexed) {
-                        if (indexed->cache) {
-                            return class_instance_factory_traits<
-                                rtti_type, typename annotated_traits<T>::type>::
-                                convert(indexed->cache);
-                        }
-                    }
-                }
+    // Resolves a const reference to an instance kept by the container, so
+    // values are accessed without being copied. Throws
+    // type_not_convertible_exception for registrations that construct a new
+    // instance for each resolution (eg. unique scope).
+    template <typename T, typename IdType = none_t>
+    const T& resolve_view(IdType&& id = IdType()) {
+        static_assert(!std::is_reference_v<T> && !std::is_pointer_v<T>,
+                      "resolve_view requires value type");
+        check_view<T>(id);
+        return resolve<const T&>(std::forward<IdType>(id));
+    }
+
+    // Resolves an unique instance of T and moves it into an arena owned by the
+    // caller. Temporaries created during the resolution are placed into
+    // the same arena. The instance stays valid until the closure is reset.
+    // std::shared_ptr<T> instances are created with std::allocate_shared()
+    // from the arena too, so copies of them must not outlive the reset.
+    // std::unique_ptr<T> still allocates the pointee, register T as a value to
+    // avoid heap allocations.
+    template <typename T, typename IdType = none_t>
+    T& resolve_into(resolving_context::closure& closure,
+                    IdType&& id = IdType()) {
+        static_assert(!std::is_reference_v<T> && !std::is_pointer_v<T>);
+        [[maybe_unused]] resolve_observer_guard<observer_type, rtti_type, T>
+            observer_guard;
+        resolving_context context(closure, get_arena_upstream());
+        if constexpr (counters_enabled) {
+            this->on_resolve();
+            try {
+                T&& instance = resolve<T&&, false, false>(
+                    context, std::forward<IdType>(id));
+                return instance;
+            } catch (...) {
+                this->on_exception();
+                throw;
             }
+        } else {
+            T&& instance =
+                resolve<T&&, false, false>(context, std::forward<IdType>(id));
+            return instance;
         }
+    }
 
-        // TODO: this destructor is really slowing things down
-        resolving_context context;
-        return resolve<T, true, false>(context, std::forward<IdType>(id));
+    // Constructs shared instances registered in this container that were not
+    // resolved yet. Instances stored by value are placed into a single region
+    // owned by the container in the order of construction, so each instance is
+    // followed by its dependencies that were not constructed before. Instances
+    // that were already resolved are kept in place. The region is sized for
+    // the instances that are not resolved yet, counting instances shared by
+    // several interfaces once. Static allocators can not allocate the region,
+    // so static containers construct the instances in their storages.
+    void finalize() {
+        resolving_context context(get_arena_upstream());
+        if constexpr (is_array_allocator<allocator_type>::value) {
+            std::size_t size = 0;
+            for (auto&& data : type_factories_) {
+                for (auto&& factory : data.second.factories)
+                    size += factory.second->get_layout_size();
+            }
+            if (size)
+                context.set_shared_region(
+                    this->allocate_shared_region(size, this));
+        }
+        for (auto&& data : type_factories_) {
+            for (auto&& factory : data.second.factories)
+                factory.second->finalize(context);
+        }
+    }
+
+    // Checks that dependencies of the registrations, including registrations
+    // in nested per-registration containers, can be resolved without
+    // constructing anything. Dependencies are the argument types of
+    // constructor<T(Args...)>, callable and function factories and the types
+    // resolved by detected constructors. Throws type_validation_exception
+    // listing the dependencies that are not registered, are ambiguous or are
+    // not provided in the requested form (eg. T&& of a shared instance).
+    // Requires diagnostics, see is_diagnostics_enabled.
+    void validate() {
+        static_assert(diagnostics_enabled,
+                      "validate() requires container traits with diagnostics");
+        type_validation validation;
+        validate(validation);
+        if (!validation.errors().empty()) {
+            std::string message;
+            for (auto& error : validation.errors())
+                message += (message.empty() ? "" : "\n") + error;
+            throw type_validation_exception(std::move(message));
+        }
+    }
+
+    // Returns registrations of the container, including nested per-registration
+    // containers, with scopes and storages. Dependencies are taken from
+    // constructor factories with explicit argument types and, if Observer is
+    // given (eg. graph_observer), from observed resolutions. Child containers
+    // created by the user export their own graphs. Requires diagnostics, see
+    // is_diagnostics_enabled.
+    template <typename Observer = void> type_graph graph() {
+        static_assert(diagnostics_enabled,
+                      "graph() requires container traits with diagnostics");
+        type_graph_builder<rtti_type> builder;
+        get_graph(builder, std::nullopt, std::nullopt);
+        if constexpr (!std::is_void_v<Observer>)
+            builder.add_observed_edges(Observer::edges());
+        return std::move(builder.graph);
+    }
+
+    // Returns an estimate of memory held by the container, see
+    // container_memory_usage. Requires diagnostics, see is_diagnostics_enabled.
+    container_memory_usage memory_usage() {
+        static_assert(
+            diagnostics_enabled,
+            "memory_usage() requires container traits with diagnostics");
+        container_memory_usage usage;
+        usage.containers += sizeof(*this);
+        get_memory_usage(usage);
+        return usage;
     }
 
     template <typename T, typename Factory = constructor_detection<decay_t<T>>>
     T construct(Factory factory = Factory()) {
         // TODO: nothrow constructuble
-        resolving_context context;
+        resolving_context context(get_arena_upstream());
         return factory.template construct<T>(context, *this);
     }
 
@@ -233,7 +484,7 @@ class container : public allocator_base<Allocator> {
                       "missing collection_traits specialization for type T");
 
         T results;
-        resolving_context context;
+        resolving_context context(get_arena_upstream());
         auto data = type_factories_.template get<decay_t<decay_t<
             typename collection_traits<T>::resolve_type>>>(); // TODO: needs to
                                                               // be
@@ -251,19 +502,13 @@ class container : public allocator_base<Allocator> {
     }
 
     template< typename Callable > auto invoke(Callable&& callable) {
-        resolving_context context;
+        resolving_context context(get_arena_upstream());
         return ::dingo::invoke< std::remove_reference_t<Callable> >::construct(
             context, *this, std::forward<Callable>(callable));
     }
 
   private:
-    template <typename... TypeArgs, typename Arg, typename IdType>
-    auto& register_type_impl(Arg&& arg, IdType&& id) {
-        using registration =
-            std::conditional_t<!is_none_v<std::decay_t<Arg>>,
-                               type_registration<TypeArgs..., factory<Arg>>,
-                               type_registration<TypeArgs...>>;
-        (void)arg;
+    template <typename Registration> struct registration_types {
         //
         // An optimization and a feature: if storage type can be only queried by
         // single interface and the interface allows for proper deletion through
@@ -274,40 +519,91 @@ class container : public allocator_base<Allocator> {
         // into stored type.
         //
         using interface_type_0 = std::tuple_element_t<
-            0, typename registration::interface_type::type_tuple>;
+            0, typename Registration::interface_type::type_tuple>;
         using stored_type = rebind_type_t<
-            typename registration::storage_type::type,
+            typename Registration::storage_type::type,
             std::conditional_t<
                 std::tuple_size_v<
-                    typename registration::interface_type::type_tuple> == 1 &&
+                    typename Registration::interface_type::type_tuple> == 1 &&
                     std::has_virtual_destructor_v<interface_type_0> &&
-                    type_traits<typename registration::storage_type::type>::
+                    type_traits<typename Registration::storage_type::type>::
                         is_pointer_type,
                 interface_type_0,
-                decay_t<typename registration::storage_type::type>>>;
+                decay_t<typename Registration::storage_type::type>>>;
 
         using storage_type =
-            detail::storage<typename registration::scope_type::type,
-                            typename registration::storage_type::type,
+            detail::storage<typename Registration::scope_type::type,
+                            typename Registration::storage_type::type,
                             stored_type,
-                            typename registration::factory_type::type,
-                            typename registration::conversions_type::type>;
+                            typename Registration::factory_type::type,
+                            typename Registration::conversions_type::type>;
+
+        using class_instance_container_traits =
+            typename ContainerTraits::template rebind_t<
+                type_list<typename ContainerTraits::tag_type,
+                          typename Registration::interface_type>>;
 
+        // Nested containers are diagnosed together with the container
         using class_instance_container_type =
             typename container_type::template rebind_t<
-                typename ContainerTraits::template rebind_t<
-                    type_list<typename ContainerTraits::tag_type,
-                              typename registration::interface_type>>,
+                std::conditional_t<
+                    diagnostics_enabled && !is_diagnostics_enabled<
+                                               class_instance_container_traits>::value,
+                    diagnostics_container_traits<class_instance_container_traits>,
+                    class_instance_container_traits>,
                 allocator_type, container_type>;
 
         using class_instance_factory_data_type =
             class_instance_factory_data<class_instance_container_type, storage_type>;
 
-        if constexpr (std::tuple_size_v<
-                          typename registration::interface_type::type_tuple> ==
-                      1) {
-            using interface_type = std::tuple_element_t<
-                0, typename registration::interface_type::type_tuple>;
+        static constexpr std::size_t interfaces_count = std::tuple_size_v<
+            typename Registration::interface_type::type_tuple>;
+
+        static constexpr std::size_t aligned_size(std::size_t size) {
+            constexpr std::size_t alignment = alignof(std::max_align_t);
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+
+        template <typename Data, typename... Interfaces>
+        static constexpr std::size_t factories_size(std::tuple<Interfaces...>*) {
+            return (aligned_size(sizeof(class_instance_factory<
+                                        container_type,
+                                        typename annotated_traits<Interfaces>::type,
+                                        storage_type, Data>)) +
+                    ...);
+        }
+
+        static constexpr std::size_t size() {
+            using type_tuple = typename Registration::interface_type::type_tuple;
+            if constexpr (interfaces_count == 1) {
+                return factories_size<class_instance_factory_data_type>(
+                    static_cast<type_tuple*>(nullptr));
+            } else {
+                // Shared data with an estimate of the control block size
+                return aligned_size(sizeof(class_instance_factory_data_type) +
+                                    2 * sizeof(void*)) +
+                       factories_size<
+                           std::shared_ptr<class_instance_factory_data_type>>(
+                           static_cast<type_tuple*>(nullptr));
+            }
+        }
+    };
+
+    template <typename... TypeArgs, typename Arg, typename IdType>
+    auto& register_type_impl(Arg&& arg, IdType&& id) {
+        using registration =
+            std::conditional_t<!is_none_v<std::decay_t<Arg>>,
+                               type_registration<TypeArgs..., factory<Arg>>,
+                               type_registration<TypeArgs...>>;
+        (void)arg;
+
+        using types = registration_types<registration>;
+        using storage_type = typename types::storage_type;
+        using class_instance_factory_data_type =
+            typename types::class_instance_factory_data_type;
+
+        if constexpr (types::interfaces_count == 1) {
+            using interface_type = typename types::interface_type_0;
 
             using class_instance_factory_type = class_instance_factory<
                 container_type, typename annotated_traits<interface_type>::type,
@@ -399,6 +695,56 @@ class container : public allocator_base<Allocator> {
         }
     }
 
+    // Resolution requested by the user, see resolve()
+    template <typename T, typename IdType, typename R>
+    R resolve_root(IdType&& id) {
+        [[maybe_unused]] resolve_observer_guard<observer_type, rtti_type,
+                                                decay_t<T>>
+            observer_guard;
+
+        // TODO: a crude way to check cache before context gets placed on the
+        // stack
+        if constexpr (cache_enabled) {
+            if constexpr (is_none_v<std::decay_t<IdType>>) {
+                void* cache = type_cache_.template get<T>();
+                if (cache) {
+                    observe_cache<T>(true);
+                    return convert_instance<T>(cache, true);
+                }
+            } else {
+                auto data = type_factories_.template get<decay_t<T>>();
+                if (data) {
+                    auto indexed =
+                        data->template get_index<IdType>(get_allocator())
+                            .find(id);
+
+                    if (indexed && indexed->cache) {
+                        observe_cache<T>(true);
+                        return convert_instance<T>(indexed->cache, true);
+                    }
+                }
+            }
+            observe_cache<T>(false);
+        }
+
+        if constexpr (adaptive_arena_enabled) {
+            // Only types registered in this container are sized
+            auto data = type_factories_.template get<decay_t<T>>();
+            resolving_context context(data ? data->get_arena_size() : 0,
+                                      get_arena_upstream());
+            arena_size_guard guard(context, data);
+            [[maybe_unused]] typename counter_type::context_guard
+                arena_guard(*this, context);
+            return resolve<T, true, false>(context, std::forward<IdType>(id));
+        } else {
+            // TODO: this destructor is really slowing things down
+            resolving_context context(get_arena_upstream());
+            [[maybe_unused]] typename counter_type::context_guard
+                arena_guard(*this, context);
+            return resolve<T, true, false>(context, std::forward<IdType>(id));
+        }
+    }
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4702)
@@ -416,11 +762,9 @@ class container : public allocator_base<Allocator> {
 
         if constexpr (cache_enabled && CheckCache) {
             void* cache = type_cache_.template get<T>();
-            if (cache) {
-                return class_instance_factory_traits<
-                    rtti_type,
-                    typename annotated_traits<T>::type>::convert(cache);
-            }
+            observe_cache<T>(cache != nullptr);
+            if (cache)
+                return convert_instance<T>(cache, true);
         }
 
         auto data = type_factories_.template get<Type>();
@@ -439,11 +783,9 @@ class container : public allocator_base<Allocator> {
 
                 if (indexed) {
                     if constexpr (cache_enabled && CheckCache) {
-                        if (indexed->cache) {
-                            return class_instance_factory_traits<
-                                rtti_type, typename annotated_traits<T>::type>::
-                                convert(indexed->cache);
-                        }
+                        observe_cache<T>(indexed->cache != nullptr);
+                        if (indexed->cache)
+                            return convert_instance<T>(indexed->cache, true);
                     }
 
                     return resolve<T, typename annotated_traits<T>::type>(
@@ -452,6 +794,8 @@ class container : public allocator_base<Allocator> {
             }
         } else if constexpr (!std::is_same_v<void*, decltype(parent_)>) {
             if (parent_) {
+                this->on_parent_walk();
+                shared_region_guard guard(context, this);
                 return parent_->template resolve<T, RemoveRvalueReferences>(
                     context, std::forward<IdType>(id));
             }
@@ -487,7 +831,7 @@ class container : public allocator_base<Allocator> {
             if (factory.cacheable)
                 type_cache_.template insert<CachedT>(ptr);
         }
-        return class_instance_factory_traits<rtti_type, T>::convert(ptr);
+        return convert_instance<T>(ptr, factory.cacheable);
     }
 
     struct index_data;
@@ -500,14 +844,69 @@ class container : public allocator_base<Allocator> {
             if (factory.cacheable)
                 data.cache = ptr;
         }
-        return class_instance_factory_traits<rtti_type, T>::convert(ptr);
+        return convert_instance<T>(ptr, factory.cacheable);
     }
 
     template <typename T, typename Factory, typename Context>
     T resolve_collection_type(Factory& factory, Context& context) {
         void* ptr = class_instance_factory_traits<rtti_type, T>::resolve(
             factory, context);
-        return class_instance_factory_traits<rtti_type, T>::convert(ptr);
+        return convert_instance<T>(ptr, factory.cacheable);
+    }
+
+    // Makes sure that the instance resolve_view<T> would return is kept by
+    // the container and not constructed for the resolution
+    template <typename T, typename IdType> void check_view(const IdType& id) {
+        auto data = type_factories_.template get<T>();
+        if (data) {
+            if constexpr (is_none_v<std::decay_t<IdType>>) {
+                (void)id;
+                if (data->factories.size() == 1 &&
+                    !data->factories.front()->cacheable)
+                    throw type_not_convertible_exception();
+            } else {
+                auto indexed =
+                    data->template get_index<std::decay_t<IdType>>(
+                            get_allocator())
+                        .find(id);
+                if (indexed && !indexed->factory->cacheable)
+                    throw type_not_convertible_exception();
+            }
+            return;
+        } else if constexpr (!std::is_same_v<void*, decltype(parent_)>) {
+            if (parent_) {
+                this->on_parent_walk();
+                return parent_->template check_view<T>(id);
+            }
+        }
+
+        throw type_not_found_exception();
+    }
+
+    template <typename T> void observe_cache(bool hit) {
+        this->on_cache_lookup(hit);
+        if constexpr (is_observer_enabled_v<observer_type>) {
+            if (hit)
+                observer_type::on_cache_hit(
+                    rtti_type::template get_type_index<decay_t<T>>());
+            else
+                observer_type::on_cache_miss(
+                    rtti_type::template get_type_index<decay_t<T>>());
+        }
+    }
+
+    // Converts resolved instance to T, applying value copy policy when
+    // an instance kept by the container is resolved by value
+    template <typename T>
+    decltype(auto) convert_instance(void* ptr, bool shared_instance) {
+        using type = typename annotated_traits<T>::type;
+        if constexpr (is_value_copy_tracked_v<type>) {
+            if (shared_instance)
+                this->on_value_copy();
+        } else {
+            (void)shared_instance;
+        }
+        return class_instance_factory_traits<rtti_type, type>::convert(ptr);
     }
 
     template <class Storage, class TypeInterface, class Type>
@@ -542,6 +941,140 @@ class container : public allocator_base<Allocator> {
         return {instance, &instance->get_container()};
     }
 
+    void get_memory_usage(container_memory_usage& usage) {
+        usage.type_factories += type_factories_.memory_usage();
+        usage.type_cache += type_cache_.memory_usage();
+        usage.storages += this->shared_regions_size();
+        for (auto&& data : type_factories_) {
+            usage.type_factories += data.second.factories.memory_usage();
+            usage.indexes += data.second.index_type::memory_usage();
+            for (auto&& factory : data.second.factories)
+                factory.second->get_memory_usage(usage);
+        }
+    }
+
+    void validate(type_validation& validation) {
+        for (auto&& data : type_factories_) {
+            for (auto&& factory : data.second.factories)
+                factory.second->validate(validation);
+        }
+    }
+
+    // Validates that T could be resolved as a dependency, following
+    // resolve(resolving_context&)
+    template <typename T> void validate_dependency(type_validation& validation) {
+        using Type = decay_t<T>;
+
+        auto data = type_factories_.template get<Type>();
+        if (data) {
+            if (data->factories.size() != 1)
+                validation.template add_error<T>("is ambiguous");
+            else if (!class_instance_factory_traits<
+                         rtti_type, typename annotated_traits<T>::type>::
+                         is_convertible(*data->factories.front()))
+                validation.template add_error<T>("is not convertible");
+            return;
+        } else if constexpr (!std::is_same_v<void*, decltype(parent_)>) {
+            if (parent_) {
+                parent_->template validate_dependency<T>(validation);
+                return;
+            }
+        }
+
+        // Aggregate types are constructed as temporaries
+        if constexpr (std::is_same_v<Type, std::decay_t<T>> &&
+                      std::is_aggregate_v<std::decay_t<T>>) {
+            using type_constructor = detail::constructor_detection<
+                Type, detail::automatic, detail::list_initialization, false>;
+            if constexpr (type_constructor::valid) {
+                detail::detected_dependencies<Type, container_type>::validate(
+                    *this, validation);
+                return;
+            }
+        }
+
+        validation.template add_error<T>("is not registered");
+    }
+
+    template <typename Builder>
+    void get_graph(Builder& builder, std::optional<std::size_t> registration,
+                   std::optional<std::size_t> parent) {
+        if constexpr (!std::is_same_v<Builder, type_graph_builder<rtti_type>>) {
+            // Nested container with different rtti
+            type_graph_builder<rtti_type> nested;
+            nested.graph = std::move(builder.graph);
+            get_graph(nested, registration, parent);
+            builder.graph = std::move(nested.graph);
+        } else {
+            std::size_t id = builder.graph.containers.size();
+            builder.graph.containers.push_back({parent, registration});
+
+            std::vector<class_instance_factory_i<container_type>*> indexed;
+            for (auto&& data : type_factories_) {
+                indexed.clear();
+                data.second.for_each_index([&](auto&, index_data& value) {
+                    indexed.push_back(value.factory);
+                });
+                for (auto&& factory : data.second.factories) {
+                    factory.second->get_graph(
+                        builder, id,
+                        std::find(indexed.begin(), indexed.end(),
+                                  factory.second.get()) != indexed.end());
+                }
+            }
+        }
+    }
+
+    struct type_factory_data;
+
+    // Remembers the temporaries of the resolution in the registration data
+    struct arena_size_guard {
+        arena_size_guard(resolving_context& context, type_factory_data* data)
+            : context_(context), data_(data) {}
+        ~arena_size_guard() {
+            if (data_)
+                data_->update_arena_size(context_.arena_used());
+        }
+
+        resolving_context& context_;
+        type_factory_data* data_;
+    };
+
+    // Instances of a parent container outlive the shared region of its child,
+    // so they are constructed in-place when resolved during child's finalize()
+    struct shared_region_guard {
+        shared_region_guard(resolving_context& context, const void* container)
+            : context_(context), region_(context.get_shared_region()) {
+            if (region_ && region_->owner == container)
+                context_.set_shared_region(nullptr);
+        }
+        ~shared_region_guard() { context_.set_shared_region(region_); }
+
+        resolving_context& context_;
+        shared_region* region_;
+    };
+
+    // Upstream of arenas of resolving contexts and closures created by the
+    // container, see is_arena_upstream_enabled
+    arena_upstream get_arena_upstream() {
+        if constexpr (arena_upstream_enabled)
+            return make_arena_upstream(get_allocator());
+        else
+            return arena_upstream();
+    }
+
+    static allocator_type get_parent_allocator(parent_container_type* parent) {
+        if constexpr (std::is_convertible_v<
+                          typename parent_container_type::allocator_type&,
+                          allocator_type>) {
+            return parent ? allocator_type(parent->get_allocator())
+                          : allocator_type();
+        } else {
+            (void)parent;
+            return allocator_type();
+        }
+    }
+
     parent_container_type* parent_ = nullptr;
 
     struct index_data {
@@ -555,7 +1088,9 @@ class container : public allocator_base<Allocator> {
         index<typename container_traits_type::index_definition_type, index_data,
               allocator_type>;
 
-    struct type_factory_data : index_type {
+    struct type_factory_data
+        : index_type,
+          type_arena_size<adaptive_arena_enabled> {
         type_factory_data(allocator_type& allocator)
             : index_type(allocator), factories(allocator) {}
 
@@ -0,0 +1,197 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/resolving_context.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace dingo {
+
+// Counters of container resolutions, see container::counters()
+struct container_counters {
+    // Resolutions requested through resolve() and resolve_into()
+    std::size_t resolves = 0;
+    // Type cache lookups, including lookups done for dependencies
+    std::size_t cache_hits = 0;
+    std::size_t cache_misses = 0;
+    // Resolutions that placed temporaries outside of the resolving context
+    // buffer, see DINGO_CONTEXT_ARENA_BUFFER_SIZE
+    std::size_t arena_spills = 0;
+    // Resolutions that threw
+    std::size_t exceptions = 0;
+    // Lookups forwarded to the parent container
+    std::size_t parent_walks = 0;
+
+    double cache_hit_ratio() const {
+        auto lookups = cache_hits + cache_misses;
+        return lookups ? double(cache_hits) / double(lookups) : 0.0;
+    }
+};
+
+template <typename Traits, typename = void>
+struct is_counters_enabled : std::bool_constant<false> {};
+
+template <typename Traits>
+struct is_counters_enabled<Traits,
+                           std::void_t<decltype(Traits::counters_enabled)>>
+    : std::bool_constant<Traits::counters_enabled> {};
+
+// Number of cache lines counters of a container are sharded into, traits can
+// define `static constexpr std::size_t counters_shards` to trade memory for
+// contention. A single shard is updated with atomic increments only.
+template <typename Traits, typename = void>
+struct counters_shards
+    : std::integral_constant<std::size_t, DINGO_COUNTERS_SHARDS> {};
+
+template <typename Traits>
+struct counters_shards<Traits, std::void_t<decltype(Traits::counters_shards)>>
+    : std::integral_constant<std::size_t, Traits::counters_shards> {};
+
+template <bool Enabled, std::size_t Shards = DINGO_COUNTERS_SHARDS>
+class container_counter {
+  public:
+    // Returns zeros, the container was not configured to count
+    container_counters counters() const { return {}; }
+
+  protected:
+    struct context_guard {
+        context_guard(container_counter&, const resolving_context&) {}
+    };
+
+    void on_resolve() {}
+    void on_exception() {}
+    void on_cache_lookup(bool) {}
+    void on_parent_walk() {}
+};
+
+// Counters sharded by thread into Shards cache lines. Running threads own one
+// of the first Shards - 1 shards each and update it with relaxed loads and
+// stores, as they are its only writer. Shards of exited threads are handed to
+// new threads. Threads that find no free shard share the last shard and
+// update it with relaxed atomic increments.
+template <std::size_t Shards> class container_counter<true, Shards> {
+    static_assert(Shards > 0 && Shards <= 65);
+
+    enum counter {
+        resolves,
+        cache_hits,
+        cache_misses,
+        arena_spills,
+        exceptions,
+        parent_walks,
+        count
+    };
+
+    struct alignas(DINGO_CACHE_LINE_SIZE) shard {
+        std::atomic<std::size_t> values[count] = {};
+    };
+
+    static constexpr std::size_t shared_shard = Shards - 1;
+
+    // Releases the shard owned by the thread when the thread exits
+    struct shard_owner {
+        ~shard_owner() {
+            auto index = shard_index_ - 1;
+            shard_index_ = shared_shard + 1;
+            owned_shards_.fetch_and(~(uint64_t(1) << index),
+                                    std::memory_order_release);
+        }
+    };
+
+    static std::size_t claim_shard() {
+        auto owned = owned_shards_.load(std::memory_order_relaxed);
+        for (std::size_t index = 0; index < shared_shard;) {
+            if (owned & (uint64_t(1) << index)) {
+                ++index;
+            } else if (owned_shards_.compare_exchange_weak(
+                           owned, owned | (uint64_t(1) << index),
+                           std::memory_order_acquire,
+                           std::memory_order_relaxed)) {
+                static thread_local shard_owner owner;
+                (void)owner;
+                return index;
+            }
+        }
+        return shared_shard;
+    }
+
+    static std::size_t get_shard_index() {
+        // Constant initialized, so the access does not check for thread_local
+        // initialization. Zero means the index was not assigned yet.
+        if (!shard_index_)
+            shard_index_ = claim_shard() + 1;
+        return shard_index_ - 1;
+    }
+
+    void increment(counter value) {
+        auto index = get_shard_index();
+        auto& atomic = shards_[index].values[value];
+        if (index != shared_shard)
+            atomic.store(atomic.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+        else
+            atomic.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::size_t get(counter value) const {
+        std::size_t result = 0;
+        for (auto& s : shards_)
+            result += s.values[value].load(std::memory_order_relaxed);
+        return result;
+    }
+
+  public:
+    // Returns counters summed over all threads. Counters are read one by one,
+    // so they are not a consistent snapshot while resolutions are running.
+    container_counters counters() const {
+        container_counters result;
+        result.resolves = get(resolves);
+        result.cache_hits = get(cache_hits);
+        result.cache_misses = get(cache_misses);
+        result.arena_spills = get(arena_spills);
+        result.exceptions = get(exceptions);
+        result.parent_walks = get(parent_walks);
+        return result;
+    }
+
+  protected:
+    // Counts whether the resolving context spilled out of its buffer
+    struct context_guard {
+        context_guard(container_counter& counter,
+                      const resolving_context& context)
+            : counter_(counter), context_(context) {}
+
+        ~context_guard() {
+            if (context_.spilled())
+                counter_.increment(arena_spills);
+        }
+
+        container_counter& counter_;
+        const resolving_context& context_;
+    };
+
+    void on_resolve() { increment(resolves); }
+    void on_exception() { increment(exceptions); }
+    void on_cache_lookup(bool hit) { increment(hit ? cache_hits : cache_misses); }
+    void on_parent_walk() { increment(parent_walks); }
+
+  private:
+    static inline thread_local std::size_t shard_index_ = 0;
+    static inline std::atomic<uint64_t> owned_shards_{0};
+
+    shard shards_[Shards];
+};
+
+} // namespace dingo
@@ -0,0 +1,38 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <type_traits>
+
+namespace dingo {
+
+// Containers with diagnostics provide memory_usage(), graph() and validate().
+// Registrations of other containers do not instantiate the code behind them.
+template <typename Traits, typename = void>
+struct is_diagnostics_enabled : std::bool_constant<false> {};
+
+template <typename Traits>
+struct is_diagnostics_enabled<
+    Traits, std::void_t<decltype(Traits::diagnostics_enabled)>>
+    : std::bool_constant<Traits::diagnostics_enabled> {};
+
+// Enables diagnostics of Traits, including the traits of nested containers:
+//
+//   container<diagnostics_container_traits<dynamic_container_traits>> container;
+//   container.validate();
+template <typename Traits> struct diagnostics_container_traits : Traits {
+    template <typename Tag>
+    using rebind_t =
+        diagnostics_container_traits<typename Traits::template rebind_t<Tag>>;
+
+    static constexpr bool diagnostics_enabled = true;
+};
+
+} // namespace dingo
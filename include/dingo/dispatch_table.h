@@ -0,0 +1,111 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/annotated.h>
+#include <dingo/class_instance_factory_i.h>
+#include <dingo/class_instance_factory_traits.h>
+#include <dingo/decay.h>
+#include <dingo/exceptions.h>
+#include <dingo/resolving_context.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace dingo {
+
+// Dense routing table built from indexed registrations of a single interface.
+// Cacheable (shared, external) registrations are resolved when the table is
+// built, so dispatching to them is a single indexed load. Non-cacheable
+// (unique) registrations keep a pointer to their factory and are constructed
+// on each dispatch. The table is a snapshot: registrations done after the table
+// was built are not visible through it. The table is local to the container:
+// registrations of parent containers are not included, and dispatches bypass
+// the container, so they are not reported to its observer or counters. Tables
+// with more than DINGO_DISPATCH_TABLE_MIN_SIZE slots must have at least one
+// registration per DINGO_DISPATCH_TABLE_MAX_SPARSITY slots, sparser keys throw
+// dispatch_table_sparse_exception.
+template <typename T, typename Key, typename Container> class dispatch_table {
+    static_assert(std::is_integral_v<Key> && std::is_unsigned_v<Key>,
+                  "dispatch_table requires unsigned integral keys");
+
+    using rtti_type = typename Container::rtti_type;
+    using value_type = typename annotated_traits<T>::type;
+    using factory_traits = class_instance_factory_traits<rtti_type, value_type>;
+
+    struct entry {
+        void* instance = nullptr;
+        class_instance_factory_i<Container>* factory = nullptr;
+    };
+
+  public:
+    dispatch_table(Container& container)
+        : upstream_(container.get_arena_upstream()) {
+        auto data = container.type_factories_.template get<decay_t<T>>();
+        if (!data)
+            return;
+
+        auto& index = data->template get_index<Key>(container.get_allocator());
+        // Computed in std::size_t so the table size does not wrap for the
+        // maximal key
+        std::size_t max_key = 0;
+        std::size_t count = 0;
+        index.for_each([&](const Key& key, auto&) {
+            max_key = std::max<std::size_t>(max_key, key);
+            ++count;
+        });
+        if (!count)
+            return;
+        if (max_key >= DINGO_DISPATCH_TABLE_MIN_SIZE &&
+            max_key / count >= DINGO_DISPATCH_TABLE_MAX_SPARSITY)
+            throw dispatch_table_sparse_exception();
+        entries_.resize(max_key + 1);
+
+        resolving_context context(upstream_);
+        index.for_each([&](const Key& key, auto& indexed) {
+            auto& e = entries_[key];
+            e.factory = indexed.factory;
+            if (Container::cache_enabled && indexed.factory->cacheable)
+                e.instance = factory_traits::resolve(*indexed.factory, context);
+        });
+    }
+
+    T resolve(Key key) {
+        if (key >= entries_.size())
+            throw type_not_found_exception();
+
+        auto& e = entries_[key];
+        if (e.instance)
+            return factory_traits::convert(e.instance);
+        if (!e.factory)
+            throw type_not_found_exception();
+
+        resolving_context context(upstream_);
+        return factory_traits::convert(factory_traits::resolve(*e.factory, context));
+    }
+
+    bool contains(Key key) const {
+        return key < entries_.size() && entries_[key].factory != nullptr;
+    }
+
+    std::size_t size() const { return entries_.size(); }
+
+  private:
+    std::vector<entry> entries_;
+    arena_upstream upstream_;
+};
+
+template <typename T, typename Key, typename Container>
+dispatch_table<T, Key, Container> make_dispatch_table(Container& container) {
+    return dispatch_table<T, Key, Container>(container);
+}
+
+} // namespace dingo
@@ -10,6 +10,8 @@
 #include <dingo/config.h>
 
 #include <exception>
+#include <string>
+#include <utility>
 
 namespace dingo {
 struct exception : std::exception {};
@@ -23,6 +25,22 @@ struct type_already_registered_exception : exception {};
 struct type_index_already_registered_exception : exception {};
 struct type_index_out_of_range_exception : exception {};
 struct type_context_overflow_exception : exception {};
+struct type_value_copy_exception : exception {};
+
+// Thrown by dispatch_table when keys are too sparse for a dense table, see
+// DINGO_DISPATCH_TABLE_MAX_SPARSITY
+struct dispatch_table_sparse_exception : exception {};
+
+// Thrown by container::validate(), what() lists the problems found
+struct type_validation_exception : exception {
+    type_validation_exception(std::string message)
+        : message_(std::move(message)) {}
+
+    const char* what() const noexcept override { return message_.c_str(); }
+
+  private:
+    std::string message_;
+};
 
 struct virtual_pointer_exception : exception {};
 
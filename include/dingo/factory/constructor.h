@@ -25,8 +25,8 @@ template <typename T, typename... Args> struct constructor<T(Args...)> {
 
     template <typename Type, typename Context, typename Container>
     static Type construct(Context& ctx, Container& container) {
-        return class_traits<Type>::construct(
-            ctx.template resolve<Args>(container)...);
+        return construct_class<Type>(ctx,
+                                     ctx.template resolve<Args>(container)...);
     }
 
     template <typename Type, typename Context, typename Container>
@@ -12,12 +12,59 @@
 #include <dingo/annotated.h>
 #include <dingo/class_traits.h>
 #include <dingo/decay.h>
+#include <dingo/diagnostics.h>
 #include <dingo/factory/constructor_typedef.h>
 #include <dingo/type_list.h>
 
 namespace dingo {
+class type_validation;
 
 namespace detail {
+// Validates that Dependency can be resolved from container, see
+// container::validate()
+struct dependency_validator {
+    template <typename Dependency, typename Container>
+    static void validate(Container& container, type_validation& validation) {
+        container.template validate_dependency<Dependency>(validation);
+    }
+};
+
+template <typename Container> struct dependency_check {
+    void (*validate)(Container&, type_validation&);
+    const dependency_check* next;
+};
+
+// Dependencies of T resolved through Container by the detected constructor.
+// Argument types are known only when the conversion operators of
+// constructor_argument_impl are instantiated, so each instantiated conversion
+// links a constant-initialized check into this list. Linking stores a single
+// pointer, so it neither allocates nor throws during static initialization.
+template <typename T, typename Container> struct detected_dependencies {
+    static inline const dependency_check<Container>* head = nullptr;
+
+    static void validate(Container& container, type_validation& validation) {
+        for (auto check = head; check; check = check->next)
+            check->validate(container, validation);
+    }
+};
+
+template <typename T, typename Container, typename Dependency>
+struct detected_dependency {
+    static inline dependency_check<Container> check = {
+        &dependency_validator::validate<Dependency, Container>, nullptr};
+    static inline const bool registered =
+        (check.next = detected_dependencies<T, Container>::head,
+         detected_dependencies<T, Container>::head = &check, true);
+};
+
+// Dependencies are recorded only for containers that can be validated
+template <typename T, typename Container, typename Dependency>
+void register_detected_dependency() {
+    if constexpr (is_diagnostics_enabled<
+                      typename Container::container_traits_type>::value)
+        (void)detected_dependency<T, Container, Dependency>::registered;
+}
+
 struct reference {};
 struct value {};
 struct automatic {};
@@ -92,18 +139,21 @@ class constructor_argument_impl<DisabledType, Context, Container, reference> {
     template <typename T, typename = std::enable_if_t<
                               !std::is_same_v<DisabledType, std::decay_t<T>>>>
     operator T*() {
+        register_detected_dependency<DisabledType, Container, T*>();
         return context_.template resolve<T*>(container_);
     }
 
     template <typename T, typename = std::enable_if_t<
                               !std::is_same_v<DisabledType, std::decay_t<T>>>>
     operator T&() {
+        register_detected_dependency<DisabledType, Container, T&>();
         return context_.template resolve<T&>(container_);
     }
 
     template <typename T, typename = std::enable_if_t<
                               !std::is_same_v<DisabledType, std::decay_t<T>>>>
     operator T&&() {
+        register_detected_dependency<DisabledType, Container, T&&>();
         return context_.template resolve<T&&>(container_);
     }
 
@@ -111,12 +161,16 @@ class constructor_argument_impl<DisabledType, Context, Container, reference> {
               typename = std::enable_if_t<
                   !std::is_same_v<DisabledType, std::decay_t<T>>>>
     operator annotated<T, Tag>() {
+        register_detected_dependency<DisabledType, Container,
+                                     annotated<T, Tag>>();
         return context_.template resolve<annotated<T, Tag>>(container_);
     }
 
     template <typename T, typename = std::enable_if_t<
                               !std::is_same_v<DisabledType, std::decay_t<T>>>>
     operator std::unique_ptr<T>() {
+        register_detected_dependency<DisabledType, Container,
+                                     std::unique_ptr<T>>();
         return context_.template resolve<std::unique_ptr<T>>(container_);
     }
 
@@ -134,6 +188,7 @@ class constructor_argument_impl<DisabledType, Context, Container, value> {
     template <typename T, typename = std::enable_if_t<
                               !std::is_same_v<DisabledType, std::decay_t<T>>>>
     operator T() {
+        register_detected_dependency<DisabledType, Container, T>();
         return context_.template resolve<T>(container_);
     }
 
@@ -141,6 +196,8 @@ class constructor_argument_impl<DisabledType, Context, Container, value> {
               typename = std::enable_if_t<
                   !std::is_same_v<DisabledType, std::decay_t<T>>>>
     operator annotated<T, Tag>() {
+        register_detected_dependency<DisabledType, Container,
+                                     annotated<T, Tag>>();
         return context_.template resolve<annotated<T, Tag>>(container_);
     }
 
@@ -160,6 +217,7 @@ class constructor_argument_impl<DisabledType, Context, Container, automatic> {
         typename = typename std::enable_if_t< !std::is_same_v<DisabledType, std::decay_t<T>> >
     >
     operator T&&() const {
+        register_detected_dependency<DisabledType, Container, T&&>();
         return context_.template resolve<T&&>(container_);
     }
 
@@ -168,6 +226,7 @@ class constructor_argument_impl<DisabledType, Context, Container, automatic> {
         typename = typename std::enable_if_t< !std::is_same_v<DisabledType, std::decay_t<T>> >
     >
     operator const T&() const {
+        register_detected_dependency<DisabledType, Container, const T&>();
         return context_.template resolve<const T&>(container_);
     }
 
@@ -176,6 +235,7 @@ class constructor_argument_impl<DisabledType, Context, Container, automatic> {
         typename = typename std::enable_if_t< !std::is_same_v<DisabledType, std::decay_t<T>> >
     >
     operator T&() const {
+        register_detected_dependency<DisabledType, Container, T&>();
         return context_.template resolve<T&>(container_);
     }
 
@@ -184,12 +244,15 @@ class constructor_argument_impl<DisabledType, Context, Container, automatic> {
         typename = typename std::enable_if_t< !std::is_same_v<DisabledType, std::decay_t<T>> >
     >
     operator T() {
+        register_detected_dependency<DisabledType, Container, T>();
         return context_.template resolve<T>(container_);
     }
 
     template <typename T, typename Tag,
               typename = std::enable_if_t< !std::is_same_v<DisabledType, std::decay_t<T>>> >
     operator annotated<T, Tag>() {
+        register_detected_dependency<DisabledType, Container,
+                                     annotated<T, Tag>>();
         return context_.template resolve<annotated<T, Tag>>(container_);
     }
 
@@ -285,7 +348,8 @@ struct constructor_methods<T, std::tuple<Args...>> {
 
     template <typename Type, typename Context, typename Container>
     static Type construct(Context& ctx, Container& container) {
-        return class_traits<Type>::construct(
+        return construct_class<Type>(
+            ctx,
             ((void)sizeof(Args),
              constructor_argument_impl<T, Context, Container,
                                        typename Args::tag_type>(ctx,
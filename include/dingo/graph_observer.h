@@ -0,0 +1,86 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/observer.h>
+
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace dingo {
+
+// Observer recording which types were resolved while resolving another type,
+// see container::graph<graph_observer<...>>(). Edges are recorded once per
+// thread into a shared set.
+template <typename RTTI, typename Tag = void>
+class graph_observer : public null_observer {
+    using type_index = typename RTTI::type_index;
+
+    struct type_index_pair_hash {
+        std::size_t operator()(
+            const std::pair<type_index, type_index>& value) const {
+            return std::hash<type_index>()(value.first) * 31 +
+                   std::hash<type_index>()(value.second);
+        }
+    };
+
+    using edge_set = std::unordered_set<std::pair<type_index, type_index>,
+                                        type_index_pair_hash>;
+
+    struct state {
+        std::mutex mutex;
+        edge_set edges;
+    };
+
+    static state& get_state() {
+        static state s;
+        return s;
+    }
+
+    struct thread_state {
+        std::vector<type_index> resolving;
+        edge_set edges;
+    };
+
+    static thread_state& get_thread_state() {
+        static thread_local thread_state s;
+        return s;
+    }
+
+  public:
+    static void on_resolve_begin(const type_index& type) {
+        auto& thread = get_thread_state();
+        if (!thread.resolving.empty() && !(thread.resolving.back() == type)) {
+            auto edge = std::make_pair(thread.resolving.back(), type);
+            if (thread.edges.insert(edge).second) {
+                auto& s = get_state();
+                std::lock_guard<std::mutex> lock(s.mutex);
+                s.edges.insert(edge);
+            }
+        }
+        thread.resolving.push_back(type);
+    }
+
+    static void on_resolve_end(const type_index&) {
+        get_thread_state().resolving.pop_back();
+    }
+
+    // Returns pairs of dependent type and its dependency observed so far
+    static std::vector<std::pair<type_index, type_index>> edges() {
+        auto& s = get_state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return {s.edges.begin(), s.edges.end()};
+    }
+};
+
+} // namespace dingo
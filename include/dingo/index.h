@@ -58,7 +58,8 @@ struct index_tag<Arg, std::tuple<Args...>>
 template <typename Key, typename Value, typename Allocator, typename Tag>
 struct index_collection;
 
-// TODO: static_allocator does not work with this
+// static_allocator allows one index collection per type, use
+// static_pool_allocator for containers with multiple indexes
 template <typename Value, typename Allocator, typename... Args> struct index {
     index(Allocator&) {}
 
@@ -97,6 +98,10 @@ template <typename Value, typename Allocator, typename... Args> struct index {
             return *index_;
         }
 
+        std::size_t memory_usage() const {
+            return index_ ? sizeof(T) + index_->memory_usage() : 0;
+        }
+
       private:
         T* index_ = nullptr;
     };
@@ -113,6 +118,30 @@ template <typename Value, typename Allocator, typename... Args> struct index {
         return *std::get<index_ptr<index_type>>(indexes_);
     }
 
+    // Calls fn(key, value) for values of all indexes
+    template <typename Fn> void for_each_index(Fn&& fn) {
+        std::visit(
+            [&](auto& ptr) {
+                if constexpr (!std::is_same_v<std::decay_t<decltype(ptr)>,
+                                              std::monostate>)
+                    (*ptr).for_each(fn);
+            },
+            indexes_);
+    }
+
+    std::size_t memory_usage() const {
+        return std::visit(
+            [](auto& ptr) -> std::size_t {
+                if constexpr (std::is_same_v<std::decay_t<decltype(ptr)>,
+                                             std::monostate>) {
+                    return 0;
+                } else {
+                    return ptr.memory_usage();
+                }
+            },
+            indexes_);
+    }
+
   private:
     std::variant<std::monostate,
                  index_ptr<index_collection<std::tuple_element_t<0, Args>,
@@ -129,6 +158,10 @@ struct index<std::tuple<Args...>, Value, Allocator>
 
 template <typename Value, typename Allocator> struct index<Value, Allocator> {
     index(Allocator&){};
+
+    template <typename Fn> void for_each_index(Fn&&) {}
+
+    std::size_t memory_usage() const { return 0; }
 };
 
 } // namespace dingo
@@ -40,6 +40,15 @@ struct index_collection<Key, Value, Allocator, index_type::array<N>> {
         return nullptr;
     }
 
+    template <typename Fn> void for_each(Fn&& fn) {
+        for (Key key = 0; key < array_.size(); ++key) {
+            if (array_[key])
+                fn(key, array_[key]);
+        }
+    }
+
+    std::size_t memory_usage() const { return 0; }
+
   private:
     std::array<Value, N> array_{};
 };
@@ -10,6 +10,7 @@
 #include <dingo/config.h>
 
 #include <dingo/index.h>
+#include <dingo/memory_usage.h>
 #include <dingo/static_allocator.h>
 
 #include <map>
@@ -35,6 +36,16 @@ struct index_collection<Key, Value, Allocator, index_type::map> {
         return it != map_.end() ? &it->second : nullptr;
     }
 
+    template <typename Fn> void for_each(Fn&& fn) {
+        for (auto& [key, value] : map_)
+            fn(key, value);
+    }
+
+    std::size_t memory_usage() const {
+        return map_.size() *
+               detail::map_node_size<typename allocator_type::value_type>();
+    }
+
   private:
     using allocator_type = typename std::allocator_traits<
         Allocator>::template rebind_alloc<std::pair<const Key, Value>>;
@@ -10,6 +10,8 @@
 #include <dingo/config.h>
 
 #include <dingo/index.h>
+#include <dingo/memory_usage.h>
+#include <dingo/static_allocator.h>
 
 #include <unordered_map>
 
@@ -21,6 +23,8 @@ struct unordered_map {};
 template <typename Key, typename Value, typename Allocator>
 struct index_collection<Key, Value, Allocator, index_type::unordered_map> {
     static_assert(!is_static_allocator_v<Allocator>);
+    // Bucket arrays need multi-object allocations
+    static_assert(!is_static_pool_allocator_v<Allocator>);
 
     index_collection(Allocator& allocator) : map_(allocator) {}
 
@@ -34,6 +38,17 @@ struct index_collection<Key, Value, Allocator, index_type::unordered_map> {
         return it != map_.end() ? &it->second : nullptr;
     }
 
+    template <typename Fn> void for_each(Fn&& fn) {
+        for (auto& [key, value] : map_)
+            fn(key, value);
+    }
+
+    std::size_t memory_usage() const {
+        return map_.bucket_count() * sizeof(void*) +
+               map_.size() * detail::unordered_map_node_size<
+                                 typename allocator_type::value_type>();
+    }
+
   private:
     using allocator_type = typename std::allocator_traits<
         Allocator>::template rebind_alloc<std::pair<const Key, Value>>;
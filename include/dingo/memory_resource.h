@@ -0,0 +1,45 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/container.h>
+
+#include <memory_resource>
+
+namespace dingo {
+
+// Container traits drawing all container memory (type maps, caches, indexes,
+// factories, storages, conversions, resolution arenas and nested containers)
+// from a std::pmr::memory_resource passed to the container constructor.
+// Instances stored as std::shared_ptr or std::unique_ptr are not container
+// memory and are allocated by the smart pointer:
+//
+//   std::pmr::monotonic_buffer_resource resource;
+//   container<pmr_container_traits<>> container(&resource);
+//
+// Child containers created without an explicit allocator use the resource of
+// their parent. Resolutions spilling out of the inline context buffers
+// allocate from the resource each time, so monotonic resources should be
+// sized for them or use an upstream that releases memory.
+template <typename IndexDefinition = std::tuple<>>
+struct pmr_container_traits : dynamic_container_traits {
+    template <typename> using rebind_t = pmr_container_traits<IndexDefinition>;
+
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+    using index_definition_type = IndexDefinition;
+    static constexpr bool arena_upstream_enabled = true;
+};
+
+namespace pmr {
+template <typename IndexDefinition = std::tuple<>>
+using container = dingo::container<pmr_container_traits<IndexDefinition>>;
+}
+
+} // namespace dingo
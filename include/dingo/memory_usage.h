@@ -0,0 +1,82 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <cstddef>
+
+namespace dingo {
+
+// Bytes held by a container, broken down by the structure holding them.
+// Node based collections are estimated from their element count, allocator
+// overhead is not included. Instances owned by storages through a pointer
+// (eg. std::unique_ptr<T>) are not included either.
+struct container_memory_usage {
+    // Container objects, including nested per-registration containers
+    std::size_t containers = 0;
+    // Type map holding registrations and their factory maps
+    std::size_t type_factories = 0;
+    // Cache of resolved instances
+    std::size_t type_cache = 0;
+    // Index collections of indexed registrations
+    std::size_t indexes = 0;
+    // Factory objects without storages and resolvers
+    std::size_t factories = 0;
+    // Storages, including instances held by value and the region of
+    // instances placed by container::finalize()
+    std::size_t storages = 0;
+    // Resolvers with conversions of resolved instances
+    std::size_t conversions = 0;
+    // Closure arenas kept by shared resolvers
+    std::size_t closures = 0;
+
+    std::size_t total() const {
+        return containers + type_factories + type_cache + indexes +
+               factories + storages + conversions + closures;
+    }
+
+    container_memory_usage& operator+=(const container_memory_usage& other) {
+        containers += other.containers;
+        type_factories += other.type_factories;
+        type_cache += other.type_cache;
+        indexes += other.indexes;
+        factories += other.factories;
+        storages += other.storages;
+        conversions += other.conversions;
+        closures += other.closures;
+        return *this;
+    }
+
+    container_memory_usage operator/(std::size_t n) const {
+        container_memory_usage usage(*this);
+        usage.containers /= n;
+        usage.type_factories /= n;
+        usage.type_cache /= n;
+        usage.indexes /= n;
+        usage.factories /= n;
+        usage.storages /= n;
+        usage.conversions /= n;
+        usage.closures /= n;
+        return usage;
+    }
+};
+
+namespace detail {
+// Estimated size of a std::map node, node header consists of color and three
+// pointers.
+template <typename T> constexpr std::size_t map_node_size() {
+    return sizeof(T) + 4 * sizeof(void*);
+}
+
+// Estimated size of a std::unordered_map node, next pointer and cached hash.
+template <typename T> constexpr std::size_t unordered_map_node_size() {
+    return sizeof(T) + 2 * sizeof(void*);
+}
+} // namespace detail
+} // namespace dingo
@@ -0,0 +1,116 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/type_name.h>
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+namespace dingo {
+
+// Observer of container events, selected by container traits with
+// observer_type. Callbacks are static and receive type indexes of the
+// container rtti, scope is the index of the storage tag (eg. shared). Custom
+// observers derive from null_observer and hide the callbacks they need.
+// Containers do not call the default observer at all, so it has no cost.
+struct null_observer {
+    // Resolution of T was requested, either by the user or as a dependency.
+    // The resolution ends with on_resolve_end, also when it throws.
+    template <typename TypeIndex> static void on_resolve_begin(const TypeIndex&) {}
+    template <typename TypeIndex> static void on_resolve_end(const TypeIndex&) {}
+
+    // Resolved instance was or was not found in the type cache
+    template <typename TypeIndex> static void on_cache_hit(const TypeIndex&) {}
+    template <typename TypeIndex> static void on_cache_miss(const TypeIndex&) {}
+
+    // Factory of registered interface type was invoked to provide an instance
+    template <typename TypeIndex>
+    static void on_factory_invoke(const TypeIndex&, const TypeIndex&) {}
+
+    // Factory constructed a new instance of stored type. Destruction is
+    // reported for instances kept by the container only, instances returned
+    // to the caller are owned by the caller.
+    template <typename TypeIndex>
+    static void on_construct(const TypeIndex&, const TypeIndex&) {}
+    template <typename TypeIndex>
+    static void on_destroy(const TypeIndex&, const TypeIndex&) {}
+
+    // Factory is about to construct an instance of stored type. The
+    // construction ends with on_construct_end, also when it throws.
+    template <typename TypeIndex>
+    static void on_construct_begin(const TypeIndex&, const TypeIndex&) {}
+    template <typename TypeIndex>
+    static void on_construct_end(const TypeIndex&, const TypeIndex&) {}
+
+    // Human readable name of a type reported by construction events, see
+    // type_name(). Reported before each on_construct_begin for the stored
+    // type and for the scope.
+    template <typename TypeIndex>
+    static void on_type_name(const TypeIndex&, std::string_view) {}
+
+    // Factory of registered interface type placed temporaries into the
+    // resolving context while providing an instance. Temporaries are counted
+    // only when DINGO_ARENA_STATISTICS is enabled.
+    template <typename TypeIndex>
+    static void on_temporaries(const TypeIndex&, std::size_t) {}
+};
+
+template <typename Traits, typename = void> struct container_observer {
+    using type = null_observer;
+};
+
+template <typename Traits>
+struct container_observer<Traits,
+                          std::void_t<typename Traits::observer_type>> {
+    using type = typename Traits::observer_type;
+};
+
+template <typename Traits>
+using container_observer_t = typename container_observer<Traits>::type;
+
+template <typename Observer>
+static constexpr bool is_observer_enabled_v =
+    !std::is_same_v<Observer, null_observer>;
+
+// Reports begin and end of a resolution of T
+template <typename Observer, typename RTTI, typename T,
+          bool Enabled = is_observer_enabled_v<Observer>>
+struct resolve_observer_guard {};
+
+template <typename Observer, typename RTTI, typename T>
+struct resolve_observer_guard<Observer, RTTI, T, true> {
+    resolve_observer_guard() {
+        Observer::on_resolve_begin(RTTI::template get_type_index<T>());
+    }
+    ~resolve_observer_guard() {
+        Observer::on_resolve_end(RTTI::template get_type_index<T>());
+    }
+};
+
+// Reports begin and end of a construction of T in Scope
+template <typename Observer, typename RTTI, typename T, typename Scope>
+struct construct_observer_guard {
+    construct_observer_guard() {
+        Observer::on_type_name(RTTI::template get_type_index<T>(),
+                               type_name<T>());
+        Observer::on_type_name(RTTI::template get_type_index<Scope>(),
+                               type_name<Scope>());
+        Observer::on_construct_begin(RTTI::template get_type_index<T>(),
+                                     RTTI::template get_type_index<Scope>());
+    }
+    ~construct_observer_guard() {
+        Observer::on_construct_end(RTTI::template get_type_index<T>(),
+                                   RTTI::template get_type_index<Scope>());
+    }
+};
+
+} // namespace dingo
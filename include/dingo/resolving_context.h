@@ -15,16 +15,43 @@
 #include <dingo/exceptions.h>
 #include <dingo/factory/constructor_detection.h>
 
+#include <iterator>
+#include <memory>
 #include <stack>
 #include <vector>
 
 namespace dingo {
 
+// Region of memory shared instances are placed into by container::finalize().
+// The header is followed by the instances. Regions of a container are linked
+// and released by the container after the instances are destroyed.
+struct shared_region {
+    shared_region(std::size_t region_size, shared_region* region_next,
+                  const void* region_owner)
+        : next(region_next), owner(region_owner), size(region_size),
+          used(sizeof(shared_region)) {}
+
+    // Returns nullptr if the region is exhausted
+    void* allocate(std::size_t bytes, std::size_t alignment) {
+        void* ptr = reinterpret_cast<uint8_t*>(this) + used;
+        std::size_t space = size - used;
+        if (!std::align(alignment, bytes, ptr, space))
+            return nullptr;
+        used = size - space + bytes;
+        return ptr;
+    }
+
+    shared_region* next;
+    const void* owner;
+    std::size_t size;
+    std::size_t used;
+};
+
 class resolving_context {
   public:   
     struct closure {
-        closure()
-            : arena_(arena_buffer_)
+        closure(arena<>& arena)
+            : arena_(arena)
             , destructibles_(arena_)
         {}
 
@@ -37,8 +64,7 @@ class resolving_context {
             arena_.reset();
         }
 
-        aligned_storage_t<DINGO_CLOSURE_ARENA_BUFFER_SIZE, alignof(std::max_align_t)> arena_buffer_;
-        arena<> arena_;
+        arena<>& arena_;
 
         struct destructible {
             void* instance;
@@ -48,15 +74,76 @@ class resolving_context {
         std::vector<destructible, arena_allocator<destructible>> destructibles_;
     };
 
-    resolving_context()
-        : arena_(arena_buffer_)
+    struct closure_arena {
+        closure_arena(arena_upstream upstream)
+            : arena_(arena_buffer_, upstream)
+        {}
+
+        aligned_storage_t<DINGO_CLOSURE_ARENA_BUFFER_SIZE, alignof(std::max_align_t)> arena_buffer_;
+        arena<> arena_;
+    };
+
+    // Closure with an inline arena buffer, further arena blocks are requested
+    // from the upstream
+    struct inline_closure : private closure_arena, closure {
+        inline_closure(arena_upstream upstream = arena_upstream())
+            : closure_arena(upstream)
+            , closure(closure_arena::arena_)
+        {}
+    };
+
+    // Closure with an inline arena buffer allocated by Owner through an
+    // allocator. Owner makes the type distinct, so static allocators provide a
+    // slot for each owner.
+    template <typename Owner> struct owned_closure : inline_closure {
+        using inline_closure::inline_closure;
+
+        bool empty() const { return closure::arena_.empty(); }
+        std::size_t size() const { return closure::arena_.size(); }
+    };
+
+    // Closure over a caller-supplied arena. Instances constructed into it
+    // during resolution are destroyed when the closure is reset or destroyed.
+    // See container::resolve_into().
+    struct arena_closure : closure {
+        arena_closure(arena<>& arena)
+            : closure(arena)
+        {}
+
+        ~arena_closure() { reset(); }
+    };
+
+    // Context requesting arena blocks beyond its inline buffers from the
+    // upstream, containers pass the upstream of their allocator
+    resolving_context(arena_upstream upstream = arena_upstream())
+        : arena_(arena_buffer_, upstream)
         , closures_(arena_)
+        , closure_(upstream)
     {
         push(&closure_);
     }
 
+    resolving_context(closure& root, arena_upstream upstream = arena_upstream())
+        : arena_(arena_buffer_, upstream)
+        , closures_(arena_)
+        , closure_(upstream)
+    {
+        push(&root);
+    }
+
+    // Context with the arena reserved for temporaries of size bytes, see
+    // arena_used()
+    resolving_context(std::size_t arena_size,
+                      arena_upstream upstream = arena_upstream())
+        : resolving_context(upstream)
+    {
+        closure_.closure::arena_.reserve(arena_size);
+    }
+
     ~resolving_context() {
-        for (auto it = closures_.rbegin(); it != closures_.rend(); ++it)
+        // Root closure supplied by the caller keeps its instances
+        auto end = closures_.front() == &closure_ ? closures_.rend() : std::prev(closures_.rend());
+        for (auto it = closures_.rbegin(); it != end; ++it)
             (*it)->reset();
     }
 
@@ -70,6 +157,9 @@ class resolving_context {
         auto instance = allocator_traits::allocate(allocator, 1);
         allocator_traits::construct(allocator, instance,
                                     std::forward<Args>(args)...);
+#if DINGO_ARENA_STATISTICS
+        ++temporaries_;
+#endif
         if constexpr (!std::is_trivially_destructible_v<T>)
             register_destructor(instance);
         return *instance;
@@ -87,6 +177,9 @@ class resolving_context {
         auto allocator = allocator_traits::rebind<Type>(alloc);
         auto instance = allocator_traits::allocate(allocator, 1);
         constructor_detection<Type, DetectionTag>().template construct<Type>(instance, *this, container);
+#if DINGO_ARENA_STATISTICS
+        ++temporaries_;
+#endif
         if constexpr (!std::is_trivially_destructible_v<Type>)
             register_destructor(instance);
         if constexpr (std::is_lvalue_reference_v<T>) {
@@ -106,6 +199,40 @@ class resolving_context {
 
     std::size_t closures_size() const { return closures_.size(); }
 
+#if DINGO_ARENA_STATISTICS
+    // Returns number of temporaries constructed by the context
+    std::size_t temporaries() const { return temporaries_; }
+#endif
+
+    // Arena of the closure supplied by the caller, smart pointers constructed
+    // directly into it allocate their instances from the arena. Resolutions
+    // running in other closures (eg. of shared instances) get nullptr.
+    arena<>* get_instance_arena() const {
+        closure* root = closures_.front();
+        return root != &closure_ && closures_.back() == root ? &root->arena_
+                                                             : nullptr;
+    }
+
+    // Region shared instances are constructed into, see container::finalize()
+    shared_region* get_shared_region() const { return shared_region_; }
+    void set_shared_region(shared_region* region) { shared_region_ = region; }
+
+    // Returns number of bytes used by temporaries in the context arena
+    std::size_t arena_used() const { return closure_.closure::arena_.used(); }
+
+    // Returns true if the context arenas allocated beyond their inline buffers
+    bool spilled() const {
+        return arena_.spilled() || closure_.closure::arena_.spilled();
+    }
+
+#if DINGO_ARENA_STATISTICS
+    arena_statistics statistics() const {
+        arena_statistics statistics = arena_.statistics();
+        statistics += closure_.closure::arena_.statistics();
+        return statistics;
+    }
+#endif
+
   private:
     template <typename T> void register_destructor(T* instance) {
         static_assert(!std::is_trivially_destructible_v<T>);
@@ -119,7 +246,11 @@ class resolving_context {
     aligned_storage_t<DINGO_CONTEXT_ARENA_BUFFER_SIZE, alignof(std::max_align_t)> arena_buffer_;
     arena<> arena_;
     std::vector<closure*, arena_allocator<closure*>> closures_;
-    closure closure_;
+    inline_closure closure_;
+    shared_region* shared_region_ = nullptr;
+#if DINGO_ARENA_STATISTICS
+    std::size_t temporaries_ = 0;
+#endif
 };
 
 } // namespace dingo
@@ -8,9 +8,14 @@
 #pragma once
 
 #include <dingo/aligned_storage.h>
+#include <dingo/allocator.h>
 #include <dingo/config.h>
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <new>
+#include <type_traits>
 
 namespace dingo {
 
@@ -50,6 +55,117 @@ template <typename T, typename Tag>
 dingo::aligned_storage_t<sizeof(T), alignof(T)>
     static_allocator<T, Tag>::storage_;
 
+// Number of slots of static_pool_allocator for a type, can be specialized to
+// size pools of particular types differently
+template <typename T, typename Tag, std::size_t Capacity>
+struct static_pool_allocator_capacity
+    : std::integral_constant<std::size_t, Capacity> {};
+
+// Allocator with a fixed pool of statically allocated slots per type and tag.
+// Only single object allocations are supported, so it can be used for node
+// based collections (eg. std::map) and for multiple factories or indexes of the
+// same type. Slots are claimed using atomic bitmap, allocation is lock-free and
+// throws std::bad_alloc when the pool is exhausted.
+template <typename T, typename Tag, std::size_t Capacity = 16>
+class static_pool_allocator {
+    static constexpr std::size_t capacity =
+        static_pool_allocator_capacity<T, Tag, Capacity>::value;
+    static constexpr std::size_t bits = sizeof(uint64_t) * 8;
+    static constexpr std::size_t words = (capacity + bits - 1) / bits;
+
+    static_assert(capacity > 0);
+
+  public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U> struct rebind {
+        using other = static_pool_allocator<U, Tag, Capacity>;
+    };
+
+    static_pool_allocator() noexcept {}
+    template <typename U>
+    static_pool_allocator(
+        const static_pool_allocator<U, Tag, Capacity>&) noexcept {}
+
+    value_type* allocate(std::size_t n) {
+        if (n == 1) {
+            for (std::size_t i = 0; i < words; ++i) {
+                uint64_t used = used_[i].load(std::memory_order_relaxed);
+                while (~used) {
+                    std::size_t bit = lowest_zero(used);
+                    std::size_t slot = i * bits + bit;
+                    if (slot >= capacity)
+                        break;
+                    if (used_[i].compare_exchange_weak(
+                            used, used | (uint64_t(1) << bit),
+                            std::memory_order_acquire,
+                            std::memory_order_relaxed))
+                        return reinterpret_cast<value_type*>(&storage_[slot]);
+                }
+            }
+        }
+        throw std::bad_alloc();
+    }
+
+    void deallocate(value_type* p, std::size_t n) noexcept {
+        (void)n;
+        assert(n == 1);
+        auto slot = static_cast<std::size_t>(
+            reinterpret_cast<slot_type*>(p) - storage_);
+        assert(slot < capacity);
+        assert(used_[slot / bits].load() & (uint64_t(1) << (slot % bits)));
+        used_[slot / bits].fetch_and(~(uint64_t(1) << (slot % bits)),
+                                     std::memory_order_release);
+    }
+
+    // Returns number of slots currently in use
+    static std::size_t size() {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < words; ++i) {
+            for (auto used = used_[i].load(std::memory_order_relaxed); used;
+                 used &= used - 1)
+                ++count;
+        }
+        return count;
+    }
+
+    static constexpr std::size_t max_size() { return capacity; }
+
+  private:
+    using slot_type = dingo::aligned_storage_t<sizeof(T), alignof(T)>;
+
+    static std::size_t lowest_zero(uint64_t value) {
+        std::size_t bit = 0;
+        while (value & (uint64_t(1) << bit))
+            ++bit;
+        return bit;
+    }
+
+    static slot_type storage_[capacity];
+    static std::atomic<uint64_t> used_[words];
+};
+
+template <typename T, typename Tag, std::size_t Capacity>
+typename static_pool_allocator<T, Tag, Capacity>::slot_type
+    static_pool_allocator<T, Tag, Capacity>::storage_
+        [static_pool_allocator<T, Tag, Capacity>::capacity];
+template <typename T, typename Tag, std::size_t Capacity>
+std::atomic<uint64_t> static_pool_allocator<T, Tag, Capacity>::used_
+    [static_pool_allocator<T, Tag, Capacity>::words];
+
+template <typename T, typename U, typename Tag, std::size_t Capacity>
+bool operator==(const static_pool_allocator<T, Tag, Capacity>&,
+                const static_pool_allocator<U, Tag, Capacity>&) noexcept {
+    return true;
+}
+
+template <typename T, typename U, typename Tag, std::size_t Capacity>
+bool operator!=(const static_pool_allocator<T, Tag, Capacity>&,
+                const static_pool_allocator<U, Tag, Capacity>&) noexcept {
+    return false;
+}
+
 template <typename Allocator>
 struct is_static_allocator : std::bool_constant<false> {};
 
@@ -61,4 +177,26 @@ template <typename Allocator>
 static constexpr bool is_static_allocator_v =
     is_static_allocator<Allocator>::value;
 
+template <typename Allocator>
+struct is_static_pool_allocator : std::bool_constant<false> {};
+
+template <typename T, typename Tag, std::size_t Capacity>
+struct is_static_pool_allocator<static_pool_allocator<T, Tag, Capacity>>
+    : std::bool_constant<true> {};
+
+template <typename Allocator>
+static constexpr bool is_static_pool_allocator_v =
+    is_static_pool_allocator<Allocator>::value;
+
+// Static allocators allocate single objects only, so static containers do not
+// use finalize() regions and their resolving contexts take arena blocks from
+// the heap
+template <typename T, typename Tag>
+struct is_array_allocator<static_allocator<T, Tag>>
+    : std::bool_constant<false> {};
+
+template <typename T, typename Tag, std::size_t Capacity>
+struct is_array_allocator<static_pool_allocator<T, Tag, Capacity>>
+    : std::bool_constant<false> {};
+
 } // namespace dingo
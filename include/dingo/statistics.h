@@ -0,0 +1,216 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/observer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace dingo {
+
+// Counters of a type collected by statistics_observer
+struct type_statistics {
+    // Resolutions requested, including resolutions of dependencies
+    std::size_t resolves = 0;
+    // Resolutions served from the type cache or not
+    std::size_t cache_hits = 0;
+    std::size_t cache_misses = 0;
+    // Instances constructed by the factory
+    std::size_t constructions = 0;
+    // Temporaries placed into resolving_context by the factory, including
+    // temporaries of the dependencies, counted with DINGO_ARENA_STATISTICS
+    std::size_t temporaries = 0;
+    // Construction time including construction of the dependencies
+    std::chrono::nanoseconds construction_time{};
+    std::chrono::nanoseconds max_construction_time{};
+
+    type_statistics& operator+=(const type_statistics& other) {
+        resolves += other.resolves;
+        cache_hits += other.cache_hits;
+        cache_misses += other.cache_misses;
+        constructions += other.constructions;
+        temporaries += other.temporaries;
+        construction_time += other.construction_time;
+        max_construction_time =
+            std::max(max_construction_time, other.max_construction_time);
+        return *this;
+    }
+};
+
+// Observer collecting type_statistics per type. Counters are kept per thread
+// and updated by the owning thread only, so the hot path does not synchronize.
+// Counters of all threads are summed on read. Containers select it with
+// `using observer_type = statistics_observer<rtti_type>;`, Tag allows to keep
+// separate statistics for different containers.
+template <typename RTTI, typename Tag = void>
+class statistics_observer : public null_observer {
+    using type_index = typename RTTI::type_index;
+    using clock = std::chrono::steady_clock;
+
+    struct counters {
+        std::atomic<std::size_t> resolves{0};
+        std::atomic<std::size_t> cache_hits{0};
+        std::atomic<std::size_t> cache_misses{0};
+        std::atomic<std::size_t> constructions{0};
+        std::atomic<std::size_t> temporaries{0};
+        std::atomic<std::int64_t> construction_time{0};
+        std::atomic<std::int64_t> max_construction_time{0};
+
+        type_statistics get() const {
+            type_statistics result;
+            result.resolves = resolves.load(std::memory_order_relaxed);
+            result.cache_hits = cache_hits.load(std::memory_order_relaxed);
+            result.cache_misses = cache_misses.load(std::memory_order_relaxed);
+            result.constructions =
+                constructions.load(std::memory_order_relaxed);
+            result.temporaries = temporaries.load(std::memory_order_relaxed);
+            result.construction_time = std::chrono::nanoseconds(
+                construction_time.load(std::memory_order_relaxed));
+            result.max_construction_time = std::chrono::nanoseconds(
+                max_construction_time.load(std::memory_order_relaxed));
+            return result;
+        }
+    };
+
+    // Single writer, so the counters do not need atomic read-modify-write
+    template <typename T> static void add(std::atomic<T>& counter, T value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+
+    struct thread_counters;
+
+    struct registry {
+        std::mutex mutex;
+        std::vector<thread_counters*> threads;
+        // Statistics of threads that exited
+        std::unordered_map<type_index, type_statistics> retired;
+    };
+
+    static registry& get_registry() {
+        static registry r;
+        return r;
+    }
+
+    struct thread_counters {
+        thread_counters() {
+            auto& r = get_registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.threads.push_back(this);
+        }
+
+        ~thread_counters() {
+            auto& r = get_registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (auto&& [type, value] : types)
+                r.retired[type] += value.get();
+            r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+        }
+
+        // Lookups are done by the owning thread only, insertions are
+        // serialized with readers
+        counters& get(const type_index& type) {
+            auto it = types.find(type);
+            if (it != types.end())
+                return it->second;
+            std::lock_guard<std::mutex> lock(mutex);
+            return types.try_emplace(type).first->second;
+        }
+
+        std::mutex mutex;
+        std::unordered_map<type_index, counters> types;
+        std::vector<clock::time_point> constructions;
+    };
+
+    static thread_counters& get_thread_counters() {
+        static thread_local thread_counters counters;
+        return counters;
+    }
+
+  public:
+    static void on_resolve_begin(const type_index& type) {
+        add<std::size_t>(get_thread_counters().get(type).resolves, 1);
+    }
+
+    static void on_cache_hit(const type_index& type) {
+        add<std::size_t>(get_thread_counters().get(type).cache_hits, 1);
+    }
+
+    static void on_cache_miss(const type_index& type) {
+        add<std::size_t>(get_thread_counters().get(type).cache_misses, 1);
+    }
+
+    static void on_construct_begin(const type_index&, const type_index&) {
+        get_thread_counters().constructions.push_back(clock::now());
+    }
+
+    static void on_construct_end(const type_index& type, const type_index&) {
+        auto& thread = get_thread_counters();
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           clock::now() - thread.constructions.back())
+                           .count();
+        thread.constructions.pop_back();
+
+        auto& counters = thread.get(type);
+        add<std::int64_t>(counters.construction_time, elapsed);
+        if (counters.max_construction_time.load(std::memory_order_relaxed) <
+            elapsed)
+            counters.max_construction_time.store(elapsed,
+                                                 std::memory_order_relaxed);
+    }
+
+    static void on_construct(const type_index& type, const type_index&) {
+        add<std::size_t>(get_thread_counters().get(type).constructions, 1);
+    }
+
+    static void on_temporaries(const type_index& type, std::size_t count) {
+        add<std::size_t>(get_thread_counters().get(type).temporaries, count);
+    }
+
+    // Returns statistics of all types summed over all threads
+    static std::unordered_map<type_index, type_statistics> statistics() {
+        auto& r = get_registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        auto result = r.retired;
+        for (auto thread : r.threads) {
+            std::lock_guard<std::mutex> thread_lock(thread->mutex);
+            for (auto&& [type, value] : thread->types)
+                result[type] += value.get();
+        }
+        return result;
+    }
+
+    // Returns statistics of T summed over all threads
+    template <typename T> static type_statistics statistics() {
+        auto type = RTTI::template get_type_index<T>();
+        auto& r = get_registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        type_statistics result;
+        auto it = r.retired.find(type);
+        if (it != r.retired.end())
+            result += it->second;
+        for (auto thread : r.threads) {
+            std::lock_guard<std::mutex> thread_lock(thread->mutex);
+            auto counters = thread->types.find(type);
+            if (counters != thread->types.end())
+                result += counters->second.get();
+        }
+        return result;
+    }
+};
+
+} // namespace dingo
@@ -30,5 +30,19 @@ struct storage_interface_requirements : std::bool_constant<true> {};
 template <typename Storage, typename Type, typename TypeInterface>
 static constexpr bool storage_interface_requirements_v =
     storage_interface_requirements<Storage, Type, TypeInterface>::value;
+
+// Bytes a storage instance needs to be placed into a shared arena, zero for
+// instances that are kept elsewhere (eg. behind a pointer)
+template <typename StorageInstance, typename = void>
+struct storage_layout_size : std::integral_constant<std::size_t, 0> {};
+
+template <typename StorageInstance>
+struct storage_layout_size<StorageInstance,
+                           std::void_t<decltype(StorageInstance::layout_size)>>
+    : std::integral_constant<std::size_t, StorageInstance::layout_size> {};
+
+template <typename StorageInstance>
+static constexpr std::size_t storage_layout_size_v =
+    storage_layout_size<StorageInstance>::value;
 } // namespace detail
 } // namespace dingo
\ No newline at end of file
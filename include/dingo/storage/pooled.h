@@ -0,0 +1,333 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/aligned_storage.h>
+#include <dingo/allocator.h>
+#include <dingo/class_instance_resolver.h>
+#include <dingo/decay.h>
+#include <dingo/factory/constructor.h>
+#include <dingo/rebind_type.h>
+#include <dingo/storage.h>
+#include <dingo/type_conversion.h>
+#include <dingo/type_list.h>
+#include <dingo/type_traits.h>
+
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace dingo {
+struct pooled {};
+
+// Customization point for pooled storage. Capacity is the number of instances
+// that are kept for recycling, reset() is called on an instance before it is
+// returned to the pool.
+template <typename T> struct pool_traits {
+    static constexpr std::size_t capacity = DINGO_POOLED_STORAGE_CAPACITY;
+    static void reset(T&) {}
+};
+
+class pool_i {
+  public:
+    virtual ~pool_i() = default;
+    virtual void release(void*) = 0;
+};
+
+// Handle to a pooled instance. When the handle is dropped, the instance is
+// returned to the pool it was obtained from. Handles may outlive the container,
+// the instance is then destroyed when the handle is dropped. Pools are not
+// synchronized, handles of a registration must be resolved and dropped by one
+// thread at a time.
+template <typename T> class pooled_ptr {
+    template <typename U> friend class pooled_ptr;
+
+  public:
+    using element_type = T;
+
+    pooled_ptr() = default;
+    pooled_ptr(T* ptr, void* instance, pool_i* pool)
+        : ptr_(ptr), instance_(instance), pool_(pool) {}
+
+    pooled_ptr(const pooled_ptr<T>&) = delete;
+    pooled_ptr(pooled_ptr<T>&& other) noexcept { swap(other); }
+
+    template <typename U, typename = std::enable_if_t<
+                              std::is_convertible_v<U*, T*>>>
+    pooled_ptr(pooled_ptr<U>&& other) noexcept
+        : ptr_(other.ptr_), instance_(other.instance_), pool_(other.pool_) {
+        other.ptr_ = nullptr;
+        other.instance_ = nullptr;
+        other.pool_ = nullptr;
+    }
+
+    ~pooled_ptr() { reset(); }
+
+    pooled_ptr<T>& operator=(const pooled_ptr<T>&) = delete;
+    pooled_ptr<T>& operator=(pooled_ptr<T>&& other) noexcept {
+        pooled_ptr<T>(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    void reset() {
+        if (pool_) {
+            pool_->release(instance_);
+            ptr_ = nullptr;
+            instance_ = nullptr;
+            pool_ = nullptr;
+        }
+    }
+
+    void swap(pooled_ptr<T>& other) noexcept {
+        std::swap(ptr_, other.ptr_);
+        std::swap(instance_, other.instance_);
+        std::swap(pool_, other.pool_);
+    }
+
+    T* get() const { return ptr_; }
+    T& operator*() const {
+        assert(ptr_);
+        return *ptr_;
+    }
+    T* operator->() const { return ptr_; }
+    explicit operator bool() const { return ptr_ != nullptr; }
+
+  private:
+    T* ptr_ = nullptr;
+    void* instance_ = nullptr;
+    pool_i* pool_ = nullptr;
+};
+
+template <class T> struct decay<pooled_ptr<T>> : decay<T> {};
+
+template <class T, class U> struct rebind_type<pooled_ptr<T>, U> {
+    using type = pooled_ptr<U>;
+};
+
+template <typename Target, typename Source>
+struct type_conversion<pooled, pooled_ptr<Target>, pooled_ptr<Source>> {
+    template <typename Factory, typename Context>
+    static pooled_ptr<Target> apply(Factory& factory, Context& context) {
+        return factory.resolve(context);
+    }
+};
+
+template <typename RTTI, typename Type, typename Storage>
+struct class_instance_resolver<RTTI, Type, Storage, pooled>
+    : class_instance_resolver<RTTI, Type, Storage, unique> {};
+
+namespace detail {
+template <typename Type, typename U> struct conversions<pooled, Type, U> {
+    using value_types = type_list<pooled_ptr<U>>;
+    using lvalue_reference_types = type_list<>;
+    using rvalue_reference_types = type_list<pooled_ptr<U>&&>;
+    using pointer_types = type_list<>;
+    using conversion_types = type_list<pooled_ptr<U>>;
+};
+
+// Instances of a pooled registration. The pool is shared by the storage and the
+// handles, it is released when the storage is destroyed and all handles were
+// returned.
+template <typename Type> class pool : public pool_i {
+  public:
+    static constexpr std::size_t capacity = pool_traits<Type>::capacity;
+    static_assert(capacity > 0);
+
+    // Returns recycled instance or nullptr if there is none
+    Type* acquire() {
+        if (!free_size_)
+            return nullptr;
+        ++outstanding_;
+        return free_[--free_size_];
+    }
+
+    // Constructs a new instance using construct(void*). When the pool is
+    // exhausted, the instance is allocated separately and it will not be
+    // recycled.
+    template <typename Construct> Type* construct(Construct&& construct) {
+        bool pooled = constructed_ < capacity;
+        void* ptr =
+            pooled ? static_cast<void*>(&instances_[constructed_]) : allocate();
+        try {
+            construct(ptr);
+        } catch (...) {
+            if (!pooled)
+                deallocate(ptr);
+            throw;
+        }
+        if (pooled)
+            ++constructed_;
+        ++outstanding_;
+        return reinterpret_cast<Type*>(ptr);
+    }
+
+    void release(void* ptr) override {
+        auto instance = static_cast<Type*>(ptr);
+        assert(outstanding_ > 0);
+        --outstanding_;
+        if (is_pooled(instance) && !detached_) {
+            assert(free_size_ < constructed_);
+            pool_traits<Type>::reset(*instance);
+            free_[free_size_++] = instance;
+            return;
+        }
+
+        instance->~Type();
+        if (!is_pooled(instance))
+            deallocate(instance);
+        if (detached_ && !outstanding_)
+            destroy();
+    }
+
+    // Called when the storage is destroyed. Recycled instances are destroyed,
+    // the outstanding ones are destroyed as their handles are dropped.
+    void detach() {
+        assert(!detached_);
+        detached_ = true;
+        for (std::size_t i = 0; i < free_size_; ++i)
+            free_[i]->~Type();
+        free_size_ = 0;
+        if (!outstanding_)
+            destroy();
+    }
+
+    std::size_t size() const { return constructed_; }
+    std::size_t available() const { return free_size_; }
+
+  protected:
+    using instance_storage_type =
+        dingo::aligned_storage_t<sizeof(Type), alignof(Type)>;
+
+    virtual void* allocate() = 0;
+    virtual void deallocate(void*) = 0;
+    virtual void destroy() = 0;
+
+  private:
+    bool is_pooled(const void* ptr) const {
+        auto instance = static_cast<const instance_storage_type*>(ptr);
+        return std::greater_equal<const instance_storage_type*>()(
+                   instance, instances_) &&
+               std::less<const instance_storage_type*>()(instance,
+                                                         instances_ + capacity);
+    }
+
+    instance_storage_type instances_[capacity];
+    Type* free_[capacity];
+    std::size_t free_size_ = 0;
+    std::size_t constructed_ = 0;
+    std::size_t outstanding_ = 0;
+    bool detached_ = false;
+};
+
+// Pool allocated through the container allocator. Instances that do not fit
+// the pool are allocated through the allocator too, static allocators allocate
+// them from the heap. The allocator is kept by the pool, so the memory it draws
+// from must outlive the handles.
+template <typename Type, typename Allocator>
+class pool_instance final : public pool<Type> {
+    using instance_storage_type = typename pool<Type>::instance_storage_type;
+
+  public:
+    pool_instance(const Allocator& allocator) : allocator_(allocator) {}
+
+    static pool<Type>* create(Allocator& allocator) {
+        auto alloc = allocator_traits::rebind<pool_instance>(allocator);
+        pool_instance* ptr = allocator_traits::allocate(alloc, 1);
+        if (!ptr)
+            throw std::bad_alloc();
+        allocator_traits::construct(alloc, ptr, allocator);
+        return ptr;
+    }
+
+  private:
+    void* allocate() override {
+        auto alloc = get_instance_allocator();
+        void* ptr = allocator_traits::allocate(alloc, 1);
+        if (!ptr)
+            throw std::bad_alloc();
+        return ptr;
+    }
+
+    void deallocate(void* ptr) override {
+        auto alloc = get_instance_allocator();
+        allocator_traits::deallocate(
+            alloc, static_cast<instance_storage_type*>(ptr), 1);
+    }
+
+    auto get_instance_allocator() {
+        if constexpr (is_array_allocator<Allocator>::value)
+            return allocator_traits::rebind<instance_storage_type>(allocator_);
+        else
+            return std::allocator<instance_storage_type>();
+    }
+
+    void destroy() override {
+        auto alloc = allocator_traits::rebind<pool_instance>(allocator_);
+        allocator_traits::destroy(alloc, this);
+        allocator_traits::deallocate(alloc, this, 1);
+    }
+
+    Allocator allocator_;
+};
+
+template <typename Type, typename StoredType, typename Factory,
+          typename Conversions>
+class storage<pooled, Type, StoredType, Factory, Conversions> : Factory {
+    static_assert(!type_traits<Type>::is_pointer_type &&
+                      std::is_same_v<Type, decay_t<Type>>,
+                  "pooled storage requires a value type");
+
+  public:
+    template <typename... Args>
+    storage(Args&&... args) : Factory(std::forward<Args>(args)...) {}
+
+    ~storage() {
+        if (pool_)
+            pool_->detach();
+    }
+
+    static constexpr bool cacheable = false;
+
+    using conversions = Conversions;
+    using type = Type;
+    using stored_type = StoredType;
+    using tag_type = pooled;
+
+    // The pool is allocated on the first resolution
+    template <typename Context, typename Container>
+    pooled_ptr<Type> resolve(Context& context, Container& container) {
+        if (!pool_) {
+            pool_ = pool_instance<
+                Type, std::decay_t<decltype(container.get_allocator())>>::
+                create(container.get_allocator());
+        }
+
+        if (auto instance = pool_->acquire())
+            return make_ptr(instance);
+
+        return make_ptr(pool_->construct([&](void* ptr) {
+            Factory::template construct<Type*>(ptr, context, container);
+        }));
+    }
+
+    std::size_t size() const { return pool_ ? pool_->size() : 0; }
+    std::size_t available() const { return pool_ ? pool_->available() : 0; }
+
+  private:
+    pooled_ptr<Type> make_ptr(Type* instance) {
+        return pooled_ptr<Type>(instance, instance, pool_);
+    }
+
+    pool<Type>* pool_ = nullptr;
+};
+} // namespace detail
+} // namespace dingo
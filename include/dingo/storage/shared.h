@@ -14,10 +14,20 @@
 #include <dingo/factory/constructor.h>
 #include <dingo/storage.h>
 #include <dingo/type_list.h>
+#include <dingo/type_traits.h>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
 
 namespace dingo {
 struct shared {};
 
+// Shared scope with the instance placed in its own cache lines, so writes to
+// the instance do not cause false sharing with the factory data read during
+// resolution
+struct shared_isolated {};
+
 namespace detail {
 template <typename Type, typename U> struct conversions<shared, Type, U> {
     using value_types = type_list<U>;
@@ -62,62 +72,108 @@ struct conversions<shared, std::optional<Type>, U> {
     using conversion_types = type_list<>;
 };
 
-template <typename Type, typename Factory>
+template <typename Type, typename U>
+struct conversions<shared_isolated, Type, U> : conversions<shared, Type, U> {};
+
+template <typename Type, typename Factory,
+          std::size_t Alignment = alignof(Type)>
 struct storage_instance_base : Factory {
+    using instance_storage_type =
+        dingo::aligned_storage_t<sizeof(Type), Alignment>;
+
+    // Instances placed into a shared region keep their address in the unused
+    // in-place storage, so instances smaller than a pointer stay in-place
+    static constexpr bool relocatable =
+        sizeof(instance_storage_type) >= sizeof(Type*);
+
+    // Bytes needed to place the instance into a shared arena, including
+    // the alignment padding
+    static constexpr std::size_t layout_size =
+        relocatable ? sizeof(instance_storage_type) + Alignment - 1 : 0;
+
     template <typename... Args>
     storage_instance_base(Args&&... args)
         : Factory(std::forward<Args>(args)...) {}
 
-    Type* get() const { return reinterpret_cast<Type*>(&instance_); }
+    Type* get() const {
+        if (state_ == state::region) {
+            Type* ptr;
+            std::memcpy(&ptr, static_cast<const void*>(&instance_),
+                        sizeof(ptr));
+            return ptr;
+        }
+        return reinterpret_cast<Type*>(&instance_);
+    }
 
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4702)
 #endif
+    // The instance is constructed into the shared region of the context if
+    // there is one with enough space (see container::finalize()), otherwise
+    // in-place
     template <typename Context, typename Container>
     void construct(Context& context, Container& container) {
-        assert(!initialized_);
+        assert(state_ == state::empty);
+        if constexpr (relocatable) {
+            if (auto region = context.get_shared_region()) {
+                if (void* ptr = region->allocate(sizeof(instance_storage_type),
+                                                 Alignment)) {
+                    Factory::template construct<Type*>(ptr, context, container);
+                    std::memcpy(static_cast<void*>(&instance_), &ptr,
+                                sizeof(ptr));
+                    state_ = state::region;
+                    return;
+                }
+            }
+        }
         Factory::template construct<Type*>(&instance_, context, container);
-        initialized_ = true;
+        state_ = state::in_place;
     }
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
 
-    bool empty() const { return !initialized_; }
+    bool empty() const { return state_ == state::empty; }
 
   protected:
-    mutable dingo::aligned_storage_t<sizeof(Type), alignof(Type)> instance_;
-    bool initialized_ = false;
+    enum class state : unsigned char { empty, in_place, region };
+
+    mutable instance_storage_type instance_;
+    state state_ = state::empty;
 };
 
 template <typename Type, typename Factory,
+          std::size_t Alignment = alignof(Type),
           bool IsTriviallyDestructible = std::is_trivially_destructible_v<Type>>
 struct storage_instance_dtor;
 
-template <typename Type, typename Factory>
-struct storage_instance_dtor<Type, Factory, true>
-    : storage_instance_base<Type, Factory> {
+template <typename Type, typename Factory, std::size_t Alignment>
+struct storage_instance_dtor<Type, Factory, Alignment, true>
+    : storage_instance_base<Type, Factory, Alignment> {
     template <typename... Args>
     storage_instance_dtor(Args&&... args)
-        : storage_instance_base<Type, Factory>(std::forward<Args>(args)...) {}
+        : storage_instance_base<Type, Factory, Alignment>(
+              std::forward<Args>(args)...) {}
 
-    void reset() { this->initialized_ = false; }
+    void reset() { this->state_ = decltype(this->state_)::empty; }
 };
 
-template <typename Type, typename Factory>
-struct storage_instance_dtor<Type, Factory, false>
-    : storage_instance_base<Type, Factory> {
+template <typename Type, typename Factory, std::size_t Alignment>
+struct storage_instance_dtor<Type, Factory, Alignment, false>
+    : storage_instance_base<Type, Factory, Alignment> {
     template <typename... Args>
     storage_instance_dtor(Args&&... args)
-        : storage_instance_base<Type, Factory>(std::forward<Args>(args)...) {}
+        : storage_instance_base<Type, Factory, Alignment>(
+              std::forward<Args>(args)...) {}
 
     ~storage_instance_dtor() { reset(); }
 
     void reset() {
-        if (this->initialized_) {
-            this->initialized_ = false;
-            this->get()->~Type();
+        if (!this->empty()) {
+            Type* instance = this->get();
+            this->state_ = decltype(this->state_)::empty;
+            instance->~Type();
         }
     }
 };
@@ -135,6 +191,25 @@ class storage_instance<shared, Type, StoredType, Factory>
         std::is_trivially_destructible_v<storage_instance_dtor<Type, Factory>>);
 };
 
+template <typename Type, typename StoredType, typename Factory>
+class storage_instance<shared_isolated, Type, StoredType, Factory>
+    : public storage_instance_dtor<
+          Type, Factory,
+          std::max<std::size_t>(alignof(Type), DINGO_CACHE_LINE_SIZE)> {
+    // Instances held through a pointer are already allocated separately
+    static_assert(!type_traits<Type>::is_pointer_type &&
+                      !std::is_pointer_v<Type>,
+                  "shared_isolated scope requires instance stored by value");
+
+  public:
+    template <typename... Args>
+    storage_instance(Args&&... args)
+        : storage_instance_dtor<
+              Type, Factory,
+              std::max<std::size_t>(alignof(Type), DINGO_CACHE_LINE_SIZE)>(
+              std::forward<Args>(args)...) {}
+};
+
 template <typename Type, typename StoredType, typename Factory>
 class storage_instance<shared, std::unique_ptr<Type>,
                        std::unique_ptr<StoredType>, Factory> : Factory {
@@ -228,18 +303,17 @@ class storage_instance<shared, std::optional<Type>, StoredType, Factory>
     mutable std::optional<Type> instance_;
 };
 
-template <typename Type, typename StoredType, typename Factory,
+template <typename Scope, typename Type, typename StoredType, typename Factory,
           typename Conversions>
-class storage<shared, Type, StoredType, Factory, Conversions>
-    : public resettable_i {
+class shared_storage : public resettable_i {
     // TODO
     // static_assert(std::is_trivially_destructible_v< Type > ==
     // std::is_trivially_destructible_v< storage_instance< Type, shared > >);
-    storage_instance<shared, Type, StoredType, Factory> instance_;
+    storage_instance<Scope, Type, StoredType, Factory> instance_;
 
   public:
     template <typename... Args>
-    storage(Args&&... args) : instance_(std::forward<Args>(args)...) {}
+    shared_storage(Args&&... args) : instance_(std::forward<Args>(args)...) {}
 
     static constexpr bool cacheable = true;
 
@@ -258,6 +332,39 @@ class storage<shared, Type, StoredType, Factory, Conversions>
 
     bool is_resolved() const { return !instance_.empty(); }
     void reset() override { instance_.reset(); }
+
+    // Bytes the instance needs in a shared arena if it is yet to be
+    // constructed
+    std::size_t layout_size() const {
+        return is_resolved()
+                   ? 0
+                   : storage_layout_size_v<
+                         storage_instance<Scope, Type, StoredType, Factory>>;
+    }
+};
+
+template <typename Type, typename StoredType, typename Factory,
+          typename Conversions>
+class storage<shared, Type, StoredType, Factory, Conversions>
+    : public shared_storage<shared, Type, StoredType, Factory, Conversions> {
+  public:
+    template <typename... Args>
+    storage(Args&&... args)
+        : shared_storage<shared, Type, StoredType, Factory, Conversions>(
+              std::forward<Args>(args)...) {}
+};
+
+// Resolves as shared scope, only the instance layout differs
+template <typename Type, typename StoredType, typename Factory,
+          typename Conversions>
+class storage<shared_isolated, Type, StoredType, Factory, Conversions>
+    : public shared_storage<shared_isolated, Type, StoredType, Factory,
+                            Conversions> {
+  public:
+    template <typename... Args>
+    storage(Args&&... args)
+        : shared_storage<shared_isolated, Type, StoredType, Factory,
+                         Conversions>(std::forward<Args>(args)...) {}
 };
 } // namespace detail
 } // namespace dingo
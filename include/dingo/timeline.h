@@ -0,0 +1,237 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/observer.h>
+#include <dingo/type_name.h>
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dingo {
+
+// Constructions recorded by timeline_observer, nested as they were performed
+struct construction_timeline {
+    struct event {
+        // Stored type and scope names
+        std::string type;
+        std::string scope;
+        // Sequential number of the thread that constructed the instance
+        std::size_t thread = 0;
+        // Construction that was in progress when this one started
+        std::optional<std::size_t> parent;
+        std::size_t depth = 0;
+        // Start is relative to the first recorded construction, duration
+        // includes construction of the dependencies
+        std::chrono::nanoseconds start{};
+        std::chrono::nanoseconds duration{};
+    };
+
+    std::vector<event> events;
+
+    // Duration of the construction without its nested constructions
+    std::chrono::nanoseconds self_time(std::size_t index) const {
+        auto result = events[index].duration;
+        for (auto& e : events) {
+            if (e.parent == index)
+                result -= e.duration;
+        }
+        return result;
+    }
+
+    // Returns self_time() of all constructions
+    std::vector<std::chrono::nanoseconds> self_times() const {
+        std::vector<std::chrono::nanoseconds> result(events.size());
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            result[i] += events[i].duration;
+            if (auto parent = events[i].parent)
+                result[*parent] -= events[i].duration;
+        }
+        return result;
+    }
+
+    // Returns the chain of nested constructions with the largest sum of self
+    // times, starting with a top-level construction
+    std::vector<std::size_t> critical_path() const {
+        // Nested constructions are recorded after their parents, so walking
+        // backwards sees the chains of all nested constructions first
+        auto chain = self_times();
+        std::vector<std::optional<std::size_t>> next(events.size());
+        std::optional<std::size_t> first;
+        for (std::size_t i = events.size(); i-- > 0;) {
+            if (next[i])
+                chain[i] += chain[*next[i]];
+            auto& longest = events[i].parent ? next[*events[i].parent] : first;
+            if (!longest || chain[*longest] <= chain[i])
+                longest = i;
+        }
+        std::vector<std::size_t> path;
+        for (auto i = first; i; i = next[*i])
+            path.push_back(*i);
+        return path;
+    }
+
+    // Writes the timeline in Chrome trace event format, events on the
+    // critical path have args.critical set
+    template <typename Stream> void write_chrome_trace(Stream& out) const {
+        std::vector<bool> critical(events.size());
+        for (auto i : critical_path())
+            critical[i] = true;
+        auto self = self_times();
+
+        out << "{\"traceEvents\":[";
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            auto& e = events[i];
+            out << (i ? ",\n" : "\n") << "{\"name\":" << detail::quote(e.type)
+                << ",\"cat\":" << detail::quote(e.scope)
+                << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+                << ",\"ts\":" << microseconds(e.start)
+                << ",\"dur\":" << microseconds(e.duration)
+                << ",\"args\":{\"self\":" << microseconds(self[i])
+                << ",\"critical\":" << (critical[i] ? "true" : "false")
+                << "}}";
+        }
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+  private:
+    static std::string microseconds(std::chrono::nanoseconds value) {
+        auto count = value.count();
+        auto fraction = std::to_string(count % 1000 + 1000);
+        return std::to_string(count / 1000) + "." + fraction.substr(1);
+    }
+};
+
+// Observer recording a timeline of constructions performed by the factories,
+// see construction_timeline. Intended for profiling of the startup, so the
+// recording is serialized by a mutex. Containers select it with
+// `using observer_type = timeline_observer<rtti_type>;`, Tag allows to keep
+// separate timelines for different containers.
+template <typename RTTI, typename Tag = void>
+class timeline_observer : public null_observer {
+    using type_index = typename RTTI::type_index;
+    using clock = std::chrono::steady_clock;
+
+    struct event {
+        type_index type;
+        type_index scope;
+        std::size_t thread;
+        std::optional<std::size_t> parent;
+        std::size_t depth;
+        clock::time_point start;
+        clock::time_point end;
+    };
+
+    struct state {
+        std::mutex mutex;
+        std::vector<event> events;
+        std::unordered_map<type_index, std::string_view> names;
+        std::size_t threads = 0;
+    };
+
+    static state& get_state() {
+        static state s;
+        return s;
+    }
+
+    struct thread_state {
+        std::optional<std::size_t> thread;
+        // Events of constructions in progress
+        std::vector<std::size_t> constructing;
+    };
+
+    static thread_state& get_thread_state() {
+        static thread_local thread_state s;
+        return s;
+    }
+
+  public:
+    static void on_type_name(const type_index& type, std::string_view name) {
+        auto& s = get_state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.names.emplace(type, name);
+    }
+
+    static void on_construct_begin(const type_index& type,
+                                   const type_index& scope) {
+        auto& thread = get_thread_state();
+        auto& s = get_state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (!thread.thread)
+            thread.thread = s.threads++;
+
+        std::optional<std::size_t> parent;
+        if (!thread.constructing.empty())
+            parent = thread.constructing.back();
+        thread.constructing.push_back(s.events.size());
+        auto now = clock::now();
+        s.events.push_back(event{type, scope, *thread.thread, parent,
+                                 thread.constructing.size() - 1, now, now});
+    }
+
+    static void on_construct_end(const type_index&, const type_index&) {
+        auto& thread = get_thread_state();
+        auto now = clock::now();
+        auto& s = get_state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.events[thread.constructing.back()].end = now;
+        thread.constructing.pop_back();
+    }
+
+    // Returns constructions recorded so far, constructions in progress have
+    // zero duration
+    static construction_timeline timeline() {
+        auto& s = get_state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        construction_timeline result;
+        if (s.events.empty())
+            return result;
+
+        auto origin = s.events.front().start;
+        result.events.reserve(s.events.size());
+        for (auto& e : s.events) {
+            construction_timeline::event value;
+            value.type = name(s, e.type);
+            value.scope = name(s, e.scope);
+            value.thread = e.thread;
+            value.parent = e.parent;
+            value.depth = e.depth;
+            value.start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                e.start - origin);
+            value.duration =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(e.end -
+                                                                     e.start);
+            result.events.push_back(std::move(value));
+        }
+        return result;
+    }
+
+    // Removes recorded constructions, eg. after the startup. Must not be
+    // called while constructions are in progress.
+    static void clear() {
+        auto& s = get_state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.events.clear();
+    }
+
+  private:
+    static std::string name(const state& s, const type_index& type) {
+        auto it = s.names.find(type);
+        return it != s.names.end() ? std::string(it->second) : std::string();
+    }
+};
+
+} // namespace dingo
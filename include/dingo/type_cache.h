@@ -9,6 +9,8 @@
 
 #include <dingo/config.h>
 
+#include <dingo/memory_usage.h>
+
 #include <map>
 #include <optional>
 // #include <unordered_map>
@@ -33,6 +35,11 @@ struct dynamic_type_cache {
         return empty_;
     }
 
+    size_t memory_usage() const {
+        return values_.size() *
+               detail::map_node_size<typename allocator_type::value_type>();
+    }
+
   private:
     using allocator_type =
         typename std::allocator_traits<Allocator>::template rebind_alloc<
@@ -108,6 +115,8 @@ struct static_type_cache {
         return node.value;
     }
 
+    size_t memory_usage() const { return size_ * sizeof(node_type); }
+
   private:
     node_type* nodes_ = nullptr;
     size_t size_ = 0;
@@ -0,0 +1,202 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/decay.h>
+#include <dingo/factory/constructor.h>
+#include <dingo/storage.h>
+#include <dingo/type_list.h>
+#include <dingo/type_name.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dingo {
+
+// Registrations of a container and dependencies between registered types, see
+// container::graph()
+struct type_graph {
+    struct container {
+        // Parent container, for nested per-registration containers
+        std::optional<std::size_t> parent;
+        // Registration the nested container belongs to
+        std::optional<std::size_t> registration;
+    };
+
+    struct node {
+        std::string interface;
+        std::string storage;
+        std::string scope;
+        std::size_t container = 0;
+        // Number of constructor arguments, if the factory is a constructor
+        std::optional<std::size_t> arity;
+        // Registration is reachable through an index
+        bool indexed = false;
+    };
+
+    struct edge {
+        // Interface names of the dependent type and of its dependency
+        std::string from;
+        std::string to;
+        // Dependency was seen during resolution, otherwise it was taken from
+        // constructor argument types
+        bool observed = false;
+
+        bool operator<(const edge& other) const {
+            return std::tie(from, to) < std::tie(other.from, other.to);
+        }
+    };
+
+    std::vector<container> containers;
+    std::vector<node> nodes;
+    std::set<edge> edges;
+
+    void add_edge(std::string from, std::string to, bool observed) {
+        auto it = edges.find(edge{from, to, observed});
+        if (it == edges.end())
+            edges.insert(edge{std::move(from), std::move(to), observed});
+        else if (observed && !it->observed)
+            edges.insert(edges.erase(it), edge{std::move(from), std::move(to), true});
+    }
+
+    // Writes the graph in Graphviz DOT format, nested containers are written
+    // as clusters
+    template <typename Stream> void write_dot(Stream& out) const {
+        out << "digraph dingo {\n";
+        for (std::size_t i = 0; i < containers.size(); ++i) {
+            if (i)
+                out << "  subgraph cluster_" << i << " {\n";
+            for (auto& n : nodes) {
+                if (n.container != i)
+                    continue;
+                out << "  " << (i ? "  " : "") << quote(n.interface)
+                    << " [label=" << quote(n.interface + "\n" + n.scope)
+                    << (n.indexed ? ", style=dashed" : "") << "];\n";
+            }
+            if (i)
+                out << "  }\n";
+        }
+        for (auto& e : edges) {
+            out << "  " << quote(e.from) << " -> " << quote(e.to)
+                << (e.observed ? "" : " [style=dotted]") << ";\n";
+        }
+        out << "}\n";
+    }
+
+    template <typename Stream> void write_json(Stream& out) const {
+        out << "{\"containers\":[";
+        for (std::size_t i = 0; i < containers.size(); ++i) {
+            out << (i ? "," : "") << "{\"id\":" << i;
+            if (containers[i].parent)
+                out << ",\"parent\":" << *containers[i].parent;
+            if (containers[i].registration)
+                out << ",\"registration\":" << *containers[i].registration;
+            out << "}";
+        }
+        out << "],\"nodes\":[";
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            auto& n = nodes[i];
+            out << (i ? "," : "") << "{\"id\":" << i
+                << ",\"interface\":" << quote(n.interface)
+                << ",\"storage\":" << quote(n.storage)
+                << ",\"scope\":" << quote(n.scope)
+                << ",\"container\":" << n.container;
+            if (n.arity)
+                out << ",\"arity\":" << *n.arity;
+            out << ",\"indexed\":" << (n.indexed ? "true" : "false") << "}";
+        }
+        out << "],\"edges\":[";
+        bool first = true;
+        for (auto& e : edges) {
+            out << (first ? "" : ",") << "{\"from\":" << quote(e.from)
+                << ",\"to\":" << quote(e.to)
+                << ",\"observed\":" << (e.observed ? "true" : "false") << "}";
+            first = false;
+        }
+        out << "]}\n";
+    }
+
+  private:
+    static std::string quote(const std::string& value) {
+        return detail::quote(value);
+    }
+};
+
+// Constructor metadata of a factory: arity for constructors, argument types
+// for constructors with explicit arguments
+template <typename Factory, typename = void> struct factory_graph_traits {
+    static std::optional<std::size_t> arity() { return std::nullopt; }
+    template <typename Fn> static void for_each_argument(Fn&&) {}
+};
+
+template <typename Factory>
+struct factory_graph_traits<Factory, std::void_t<decltype(Factory::arity)>> {
+    static std::optional<std::size_t> arity() { return Factory::arity; }
+    template <typename Fn> static void for_each_argument(Fn&&) {}
+};
+
+template <typename T, typename... Args>
+struct factory_graph_traits<constructor<T(Args...)>> {
+    static std::optional<std::size_t> arity() { return sizeof...(Args); }
+    template <typename Fn> static void for_each_argument(Fn&& fn) {
+        for_each(type_list<decay_t<Args>...>{}, fn);
+    }
+};
+
+template <typename T, typename... Args>
+struct factory_graph_traits<constructor<T, Args...>>
+    : factory_graph_traits<constructor<T(Args...)>> {};
+
+// Graph being built together with names of registered types, so observed
+// dependencies can be named
+template <typename RTTI> struct type_graph_builder {
+    type_graph graph;
+    std::unordered_map<typename RTTI::type_index, std::string> names;
+    // Nested containers already added, multi-interface registrations share
+    // a single nested container
+    std::vector<const void*> visited;
+
+    bool visit(const void* container) {
+        if (std::find(visited.begin(), visited.end(), container) !=
+            visited.end())
+            return false;
+        visited.push_back(container);
+        return true;
+    }
+
+    template <typename Edges> void add_observed_edges(const Edges& edges) {
+        for (auto&& [from, to] : edges) {
+            auto from_name = names.find(from);
+            auto to_name = names.find(to);
+            if (from_name != names.end() && to_name != names.end())
+                graph.add_edge(from_name->second, to_name->second, true);
+        }
+    }
+};
+
+namespace detail {
+template <typename Storage> struct storage_factory;
+
+template <typename StorageTag, typename Type, typename StoredType,
+          typename Factory, typename Conversions>
+struct storage_factory<
+    storage<StorageTag, Type, StoredType, Factory, Conversions>> {
+    using type = Factory;
+};
+} // namespace detail
+
+} // namespace dingo
@@ -9,6 +9,8 @@
 
 #include <dingo/config.h>
 
+#include <dingo/memory_usage.h>
+
 #include <map>
 #include <optional>
 // #include <unordered_map>
@@ -36,6 +38,11 @@ struct dynamic_type_map {
 
     size_t size() const { return values_.size(); }
 
+    size_t memory_usage() const {
+        return values_.size() *
+               detail::map_node_size<typename allocator_type::value_type>();
+    }
+
     Value& front() {
         assert(!values_.empty());
         return values_.begin()->second;
@@ -133,6 +140,8 @@ struct static_type_map {
 
     size_t size() const { return size_; }
 
+    size_t memory_usage() const { return size_ * sizeof(node_type); }
+
     Value& front() {
         assert(nodes_);
         return *nodes_->value;
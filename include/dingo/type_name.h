@@ -0,0 +1,68 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <string>
+#include <string_view>
+
+namespace dingo {
+
+// Returns human readable name of T, extracted from the function signature so
+// it is available without RTTI. The format is compiler-specific.
+template <typename T> std::string_view type_name() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    std::string_view name = __FUNCSIG__;
+    auto begin = name.find("type_name<") + 10;
+    auto end = name.rfind(">(void)");
+#else
+    std::string_view name = __PRETTY_FUNCTION__;
+    auto begin = name.find("T = ") + 4;
+    auto end = name.find_first_of(";]", begin);
+#endif
+    return name.substr(begin, end - begin);
+}
+
+namespace detail {
+// Returns value as a quoted string for JSON and DOT output. Quotes,
+// backslashes and control characters are escaped, new lines as \n.
+inline std::string quote(std::string_view value) {
+    static constexpr char hex[] = "0123456789abcdef";
+    std::string result = "\"";
+    for (auto c : value) {
+        switch (c) {
+        case '"':
+        case '\\':
+            result += '\\';
+            result += c;
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                result += "\\u00";
+                result += hex[static_cast<unsigned char>(c) >> 4];
+                result += hex[c & 0xf];
+            } else {
+                result += c;
+            }
+        }
+    }
+    return result + "\"";
+}
+} // namespace detail
+
+} // namespace dingo
@@ -0,0 +1,134 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/factory/callable.h>
+#include <dingo/factory/constructor.h>
+#include <dingo/factory/constructor_detection.h>
+#include <dingo/factory/function.h>
+#include <dingo/type_list.h>
+#include <dingo/type_name.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dingo {
+
+// Problems found by container::validate()
+class type_validation {
+  public:
+    // Registration whose dependencies are validated
+    void set_registration(std::string_view registration) {
+        registration_ = registration;
+    }
+
+    // Dependency T of the current registration can not be resolved
+    template <typename T> void add_error(std::string_view reason) {
+        std::string error(registration_);
+        error += ": ";
+        error += type_name<T>();
+        error += " ";
+        error += reason;
+        if (std::find(errors_.begin(), errors_.end(), error) == errors_.end())
+            errors_.push_back(std::move(error));
+    }
+
+    const std::vector<std::string>& errors() const { return errors_; }
+
+  private:
+    std::string_view registration_;
+    std::vector<std::string> errors_;
+};
+
+namespace detail {
+template <typename Container, typename... Args>
+void validate_dependencies(Container& container, type_validation& validation,
+                           type_list<Args...>) {
+    (dependency_validator::validate<Args>(container, validation), ...);
+}
+
+template <typename T> struct function_dependencies;
+
+template <typename R, typename... Args>
+struct function_dependencies<R (*)(Args...)> {
+    using type = type_list<Args...>;
+};
+
+template <typename R, typename... Args>
+struct function_dependencies<R(Args...)> {
+    using type = type_list<Args...>;
+};
+
+template <typename R, typename T, typename... Args>
+struct function_dependencies<R (T::*)(Args...) const> {
+    using type = type_list<Args...>;
+};
+} // namespace detail
+
+// Validates dependencies a factory resolves to construct an instance.
+// Factories with unknown dependencies are not validated.
+template <typename Factory> struct factory_dependencies {
+    template <typename Container>
+    static void validate(Container&, type_validation&) {}
+};
+
+template <typename T, typename... Args>
+struct factory_dependencies<constructor<T(Args...)>> {
+    template <typename Container>
+    static void validate(Container& container, type_validation& validation) {
+        detail::validate_dependencies(container, validation,
+                                      type_list<Args...>{});
+    }
+};
+
+template <typename T, typename... Args>
+struct factory_dependencies<constructor<T, Args...>>
+    : factory_dependencies<constructor<T(Args...)>> {};
+
+template <typename T, typename DetectionType>
+struct factory_dependencies<constructor_detection<T, DetectionType>> {
+    template <typename Container>
+    static void validate(Container& container, type_validation& validation) {
+        if constexpr (has_constructor_typedef_v<T>) {
+            factory_dependencies<typename T::dingo_constructor_type>::validate(
+                container, validation);
+        } else {
+            detail::detected_dependencies<T, Container>::validate(container,
+                                                                 validation);
+        }
+    }
+};
+
+template <typename T> struct factory_dependencies<callable<T>> {
+    template <typename Container>
+    static void validate(Container& container, type_validation& validation) {
+        detail::validate_dependencies(
+            container, validation,
+            typename detail::function_dependencies<decltype(
+                &T::operator())>::type{});
+    }
+};
+
+template <typename T, T fn> struct factory_dependencies<function_decl<T, fn>> {
+    template <typename Container>
+    static void validate(Container& container, type_validation& validation) {
+        detail::validate_dependencies(
+            container, validation,
+            typename detail::function_dependencies<T>::type{});
+    }
+};
+
+template <auto fn>
+struct factory_dependencies<function<fn>>
+    : factory_dependencies<function_decl<decltype(fn), fn>> {};
+
+} // namespace dingo
@@ -0,0 +1,83 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <dingo/config.h>
+
+#include <dingo/exceptions.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace dingo {
+
+// Policies applied when a shared instance (an instance a container keeps, eg.
+// with shared or external scope) is resolved by value and thus copied.
+// Container traits select the policy with value_copy_policy type.
+namespace value_copy {
+// Copies are allowed silently
+struct allow {};
+// Copies are counted, see container::value_copies()
+struct count {};
+// Copies throw type_value_copy_exception
+struct forbid {};
+} // namespace value_copy
+
+template <typename Traits, typename = void> struct container_value_copy_policy {
+    using type = value_copy::allow;
+};
+
+template <typename Traits>
+struct container_value_copy_policy<
+    Traits, std::void_t<typename Traits::value_copy_policy>> {
+    using type = typename Traits::value_copy_policy;
+};
+
+template <typename Traits>
+using container_value_copy_policy_t =
+    typename container_value_copy_policy<Traits>::type;
+
+// Copying std::shared_ptr<> shares the instance, so it is not tracked
+template <typename T> struct is_value_copy_tracked : std::true_type {};
+template <typename T>
+struct is_value_copy_tracked<std::shared_ptr<T>> : std::false_type {};
+
+template <typename T>
+static constexpr bool is_value_copy_tracked_v =
+    !std::is_reference_v<T> && !std::is_pointer_v<T> &&
+    is_value_copy_tracked<T>::value;
+
+template <typename Policy> struct value_copy_counter {
+  protected:
+    void on_value_copy() {}
+};
+
+template <> struct value_copy_counter<value_copy::count> {
+    // Returns number of shared instances that were copied by value resolution
+    std::size_t value_copies() const {
+        return value_copies_.load(std::memory_order_relaxed);
+    }
+
+  protected:
+    // Resolutions can run concurrently, the counter is only a statistic
+    void on_value_copy() {
+        value_copies_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<std::size_t> value_copies_{0};
+};
+
+template <> struct value_copy_counter<value_copy::forbid> {
+  protected:
+    void on_value_copy() { throw type_value_copy_exception(); }
+};
+
+} // namespace dingo
@@ -5,12 +5,17 @@
 // SPDX-License-Identifier: MIT
 //
 
+#include <dingo/arena_allocator.h>
 #include <dingo/container.h>
+#include <dingo/storage/pooled.h>
 #include <dingo/storage/shared.h>
 #include <dingo/storage/unique.h>
 
 #include <gtest/gtest.h>
 
+#include <map>
+#include <vector>
+
 namespace dingo {
 
 // Taken from
@@ -129,4 +134,243 @@ TYPED_TEST(allocator_test, user_allocator_shared) {
     ASSERT_GE(alloc.get_allocated(), 0);
 }
 
+TYPED_TEST(allocator_test, user_allocator_conversions) {
+    using container_type = TypeParam;
+
+    struct I {
+        virtual ~I() = default;
+    };
+    struct A : I {};
+
+    test_allocator<char> alloc;
+    ASSERT_EQ(alloc.get_allocated(), 0);
+    {
+        container_type container(alloc);
+        container.template register_type<scope<shared>,
+                                         storage<std::shared_ptr<A>>,
+                                         interfaces<I, A>>();
+        container.template resolve<std::shared_ptr<A>&>();
+        std::size_t allocated = alloc.get_allocated();
+
+        // Conversion to std::shared_ptr<I> is allocated through the allocator
+        container.template resolve<std::shared_ptr<I>&>();
+        ASSERT_GE(alloc.get_allocated(),
+                  allocated + sizeof(std::shared_ptr<I>));
+    }
+    ASSERT_EQ(alloc.get_allocated(), 0);
+}
+
+TYPED_TEST(allocator_test, user_allocator_finalize) {
+    using container_type = TypeParam;
+
+    struct A {
+        A() {}
+        std::size_t value[8] = {};
+    };
+
+    test_allocator<char> alloc;
+    ASSERT_EQ(alloc.get_allocated(), 0);
+    {
+        container_type container(alloc);
+        container.template register_type<scope<shared>, storage<A>>();
+        std::size_t allocated = alloc.get_allocated();
+
+        // Region of finalized instances is allocated through the allocator
+        // only when finalize() is called
+        container.finalize();
+        ASSERT_GE(alloc.get_allocated(), allocated + sizeof(A));
+        container.template resolve<A&>();
+    }
+    ASSERT_EQ(alloc.get_allocated(), 0);
+}
+
+TYPED_TEST(allocator_test, user_allocator_finalize_size) {
+    using container_type = TypeParam;
+
+    struct I1 {
+        virtual ~I1() = default;
+    };
+    struct I2 {
+        virtual ~I2() = default;
+    };
+    struct I3 {
+        virtual ~I3() = default;
+    };
+    struct A : I1, I2, I3 {
+        A() {}
+        std::size_t value[32] = {};
+    };
+    struct B {
+        B() {}
+        std::size_t value[32] = {};
+    };
+
+    test_allocator<char> alloc;
+    {
+        container_type container(alloc);
+        container.template register_type<scope<shared>, storage<A>,
+                                         interfaces<I1, I2, I3>>();
+        container.template register_type<scope<shared>, storage<B>>();
+        container.template resolve<B&>();
+        std::size_t allocated = alloc.get_allocated();
+
+        // The instance shared by three interfaces is reserved once, the
+        // resolved instance is not reserved at all
+        container.finalize();
+        ASSERT_GE(alloc.get_allocated(), allocated + sizeof(A));
+        ASSERT_LT(alloc.get_allocated(), allocated + sizeof(A) + sizeof(B));
+        ASSERT_EQ(&container.template resolve<I1&>(),
+                  static_cast<I1*>(&static_cast<A&>(
+                      container.template resolve<I2&>())));
+    }
+    ASSERT_EQ(alloc.get_allocated(), 0);
+}
+
+TYPED_TEST(allocator_test, user_allocator_pooled) {
+    using container_type = TypeParam;
+
+    struct A {
+        A() {}
+        std::size_t value[8] = {};
+    };
+
+    test_allocator<char> alloc;
+    ASSERT_EQ(alloc.get_allocated(), 0);
+    {
+        container_type container(alloc);
+        container.template register_type<scope<pooled>, storage<A>>();
+        std::size_t allocated = alloc.get_allocated();
+
+        // The pool and instances that do not fit into it are allocated through
+        // the allocator
+        std::vector<pooled_ptr<A>> instances;
+        instances.push_back(container.template resolve<pooled_ptr<A>>());
+        ASSERT_GE(alloc.get_allocated(),
+                  allocated + DINGO_POOLED_STORAGE_CAPACITY * sizeof(A));
+        for (size_t i = 0; i < DINGO_POOLED_STORAGE_CAPACITY; ++i)
+            instances.push_back(container.template resolve<pooled_ptr<A>>());
+        std::size_t pooled = alloc.get_allocated();
+        instances.push_back(container.template resolve<pooled_ptr<A>>());
+        ASSERT_EQ(alloc.get_allocated(), pooled + sizeof(A));
+    }
+    ASSERT_EQ(alloc.get_allocated(), 0);
+}
+
+TEST(arena_allocator_test, registrations) {
+    struct A {
+        A() {}
+        int value = 1;
+    };
+
+    struct IB {
+        virtual ~IB() {}
+        virtual int value() const = 0;
+    };
+
+    struct B : IB {
+        B(A& a) : a_(a) {}
+        int value() const override { return a_.value; }
+        A& a_;
+    };
+
+    using allocator_type = arena_allocator<char>;
+    using container_type = container<dynamic_container_traits, allocator_type>;
+
+    constexpr size_t size =
+        container_type::registration_size<scope<shared>, storage<A>>() +
+        container_type::registration_size<scope<shared>, storage<B>,
+                                          interfaces<IB, B>>();
+    static_assert(size > sizeof(A) + sizeof(B));
+
+    // Factories with their storages are placed into the buffer one after
+    // another, the rest of the buffer is used by the container type maps
+    alignas(std::max_align_t) uint8_t buffer[size + 2048];
+    arena<> arena(buffer);
+    {
+        container_type container{allocator_type(arena)};
+        container.register_type<scope<shared>, storage<A>>();
+        container.register_type<scope<shared>, storage<B>,
+                                interfaces<IB, B>>();
+
+        auto& a = container.resolve<A&>();
+        ASSERT_GE(reinterpret_cast<uint8_t*>(&a), buffer);
+        ASSERT_LT(reinterpret_cast<uint8_t*>(&a), buffer + sizeof(buffer));
+
+        auto& b = container.resolve<IB&>();
+        ASSERT_EQ(b.value(), 1);
+        ASSERT_EQ(&container.resolve<B&>(), &b);
+        ASSERT_GE(reinterpret_cast<uint8_t*>(&b), buffer);
+        ASSERT_LT(reinterpret_cast<uint8_t*>(&b), buffer + sizeof(buffer));
+    }
+}
+
+TEST(arena_allocator_test, resolve) {
+    struct A {
+        A() {}
+        char data[1024];
+    };
+
+    struct B {
+        B(A&& a0, A&& a1, A&& a2, A&& a3)
+            : value(a0.data[0] + a1.data[0] + a2.data[0] + a3.data[0]) {}
+        int value;
+    };
+
+    using allocator_type = arena_allocator<char>;
+    using container_type = container<dynamic_container_traits, allocator_type>;
+
+    alignas(std::max_align_t) uint8_t buffer[4096];
+    arena<> arena(buffer);
+    {
+        container_type container{allocator_type(arena)};
+        container.register_type<scope<unique>, storage<A>>();
+        container.register_type<scope<unique>, storage<B>>();
+
+        // Temporaries spill out of the resolving context buffer, yet the
+        // context arenas do not take blocks from the container arena
+        container.resolve<B>();
+        std::size_t used = arena.used();
+        for (size_t i = 0; i < 8; ++i) {
+            container.resolve<B>();
+            ASSERT_EQ(arena.used(), used);
+        }
+    }
+}
+
+TEST(static_pool_allocator_test, allocate) {
+    struct tag {};
+    using allocator_type = static_pool_allocator<int, tag, 4>;
+    allocator_type allocator;
+
+    int* ptrs[4];
+    for (auto& ptr : ptrs)
+        ptr = allocator.allocate(1);
+    ASSERT_EQ(allocator_type::size(), 4);
+    ASSERT_THROW(allocator.allocate(1), std::bad_alloc);
+
+    allocator.deallocate(ptrs[1], 1);
+    ASSERT_EQ(allocator.allocate(1), ptrs[1]);
+    for (auto& ptr : ptrs)
+        allocator.deallocate(ptr, 1);
+    ASSERT_EQ(allocator_type::size(), 0);
+
+    // Rebound allocators use separate pools
+    static_pool_allocator<double, tag, 4> other(allocator);
+    other.deallocate(other.allocate(1), 1);
+    ASSERT_EQ(allocator_type::size(), 0);
+}
+
+TEST(static_pool_allocator_test, map) {
+    struct tag {};
+    using allocator_type =
+        static_pool_allocator<std::pair<const int, int>, tag, 8>;
+    std::map<int, int, std::less<int>, allocator_type> map;
+    for (int i = 0; i < 8; ++i)
+        map.emplace(i, i);
+    ASSERT_THROW(map.emplace(8, 8), std::bad_alloc);
+    map.erase(0);
+    map.emplace(8, 8);
+    ASSERT_EQ(map.size(), 8);
+}
+
 } // namespace dingo
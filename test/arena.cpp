@@ -0,0 +1,215 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/arena_allocator.h>
+#include <dingo/container.h>
+#include <dingo/resolving_context.h>
+#include <dingo/storage/unique.h>
+
+#include <gtest/gtest.h>
+
+namespace dingo {
+TEST(arena_test, used) {
+    alignas(std::max_align_t) uint8_t buffer[128];
+    arena<> arena(buffer);
+    ASSERT_EQ(arena.used(), 0);
+    ASSERT_TRUE(arena.empty());
+
+    arena.allocate(16, 8);
+    ASSERT_EQ(arena.used(), 16);
+    ASSERT_EQ(arena.size(), 0);
+
+    // Spill into a heap block
+    arena.allocate(256, 8);
+    ASSERT_GE(arena.used(), 16 + 256);
+    ASSERT_GT(arena.size(), 0);
+
+    arena.reset();
+    ASSERT_EQ(arena.used(), 0);
+    ASSERT_EQ(arena.size(), 0);
+}
+
+TEST(arena_test, reserve) {
+    alignas(std::max_align_t) uint8_t buffer[128];
+    arena<> arena(buffer);
+
+    // Fits into the buffer, no block is requested
+    arena.reserve(64);
+    ASSERT_EQ(arena.size(), 0);
+
+    arena.reserve(1024);
+    auto size = arena.size();
+    ASSERT_GE(size, 1024);
+    for (size_t i = 0; i < 1024 / 16; ++i)
+        arena.allocate(16, 16);
+    ASSERT_EQ(arena.size(), size);
+
+#if DINGO_ARENA_STATISTICS
+    ASSERT_EQ(arena.statistics().blocks + arena.statistics().cached_blocks, 1);
+    ASSERT_EQ(arena.statistics().allocated, 1024);
+#endif
+}
+
+// Allocations are counted for all rebound types together
+struct arena_test_allocator_stats {
+    static inline size_t allocations = 0;
+};
+
+template <typename T>
+struct arena_test_allocator : std::allocator<T>, arena_test_allocator_stats {
+    template <typename U> struct rebind {
+        using other = arena_test_allocator<U>;
+    };
+
+    arena_test_allocator() = default;
+    template <typename U>
+    arena_test_allocator(const arena_test_allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        ++allocations;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+TEST(arena_test, block_cache) {
+    alignas(std::max_align_t) uint8_t buffer[128];
+    arena<arena_test_allocator<uint8_t>> arena(buffer);
+
+    arena_test_allocator<uint8_t>::allocations = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        arena.allocate(1024, 8);
+        arena.allocate(8192, 8);
+        arena.reset();
+    }
+
+    // Spilled blocks are reused after the first iteration
+    ASSERT_EQ(arena_test_allocator<uint8_t>::allocations, 2);
+}
+
+struct arena_test_temporary {
+    arena_test_temporary() {}
+    char data[256];
+};
+
+struct arena_test_class {
+    arena_test_class(arena_test_temporary&& a, arena_test_temporary&& b)
+        : value(a.data[0] + b.data[0]) {}
+    int value;
+};
+
+TEST(arena_test, resolving_context) {
+    container<> container;
+    container.register_type<scope<unique>, storage<arena_test_temporary>>();
+    container.register_type<scope<unique>, storage<arena_test_class>>();
+
+    resolving_context context;
+    ASSERT_EQ(context.arena_used(), 0);
+    context.resolve<arena_test_class>(container);
+    ASSERT_GE(context.arena_used(), 2 * sizeof(arena_test_temporary));
+}
+
+// Arena blocks are requested through the container allocator so they can be
+// counted
+struct upstream_container_traits : dynamic_container_traits {
+    static constexpr bool arena_upstream_enabled = true;
+};
+
+struct adaptive_container_traits : upstream_container_traits {
+    static constexpr bool adaptive_arena_enabled = true;
+};
+
+struct arena_test_large_temporary {
+    arena_test_large_temporary() {}
+    char data[3072];
+};
+
+struct arena_test_large_class {
+    arena_test_large_class(arena_test_large_temporary&& a,
+                           arena_test_large_temporary&& b,
+                           arena_test_large_temporary&& c,
+                           arena_test_large_temporary&& d)
+        : value(a.data[0] + b.data[0] + c.data[0] + d.data[0]) {}
+    int value;
+};
+
+// Returns number of allocations made by a resolution of arena_test_large_class,
+// arena blocks are requested through the container allocator
+template <typename Container> size_t arena_test_resolve(Container& container) {
+    arena_test_allocator_stats::allocations = 0;
+    container.template resolve<arena_test_large_class>();
+    return arena_test_allocator_stats::allocations;
+}
+
+template <typename Container> void arena_test_register(Container& container) {
+    container.template register_type<scope<unique>,
+                                     storage<arena_test_large_temporary>>();
+    container.template register_type<scope<unique>,
+                                     storage<arena_test_large_class>>();
+}
+
+TEST(arena_test, adaptive) {
+    using container_type =
+        container<adaptive_container_traits, arena_test_allocator<char>>;
+
+    container_type container;
+    arena_test_register(container);
+
+    // The first resolution spills into several growing blocks
+    size_t allocations = arena_test_resolve(container);
+    ASSERT_GT(allocations, 1);
+
+    // The following resolutions reserve the learned size in a single block
+    for (size_t i = 0; i < 4; ++i)
+        ASSERT_EQ(arena_test_resolve(container), 1);
+
+    // The size is learned by each container
+    container_type other;
+    arena_test_register(other);
+    ASSERT_EQ(arena_test_resolve(other), allocations);
+    ASSERT_EQ(arena_test_resolve(other), 1);
+}
+
+TEST(arena_test, upstream_disabled) {
+    container<dynamic_container_traits, arena_test_allocator<char>> container;
+    arena_test_register(container);
+
+    // Blocks come from the heap and the thread-local block cache
+    for (size_t i = 0; i < 4; ++i)
+        ASSERT_EQ(arena_test_resolve(container), 0);
+}
+
+TEST(arena_test, adaptive_disabled) {
+    container<upstream_container_traits, arena_test_allocator<char>> container;
+    arena_test_register(container);
+
+    size_t allocations = arena_test_resolve(container);
+    ASSERT_GT(allocations, 1);
+    for (size_t i = 0; i < 4; ++i)
+        ASSERT_EQ(arena_test_resolve(container), allocations);
+}
+
+#if DINGO_ARENA_STATISTICS
+TEST(arena_test, adaptive_statistics) {
+    container<> container;
+    arena_test_register(container);
+
+    resolving_context learning;
+    learning.resolve<arena_test_large_class>(container);
+    ASSERT_GT(learning.statistics().blocks + learning.statistics().cached_blocks,
+              1);
+
+    // Context reserved with the observed size requests a single block
+    resolving_context context(learning.arena_used());
+    context.resolve<arena_test_large_class>(container);
+    ASSERT_EQ(context.statistics().blocks + context.statistics().cached_blocks,
+              1);
+    ASSERT_GE(context.statistics().high_water_mark,
+              4 * sizeof(arena_test_large_temporary));
+}
+#endif
+
+} // namespace dingo
@@ -64,3 +64,15 @@ using container_types = ::testing::Types<
     dingo::container<static_container_without_cache<>>,
     dingo::container<dynamic_container_with_static_rtti_traits>,
     dingo::container<dynamic_container_without_cache>>;
+
+template <typename Traits>
+using diagnostics_container = dingo::container<
+    dingo::diagnostics_container_traits<Traits>>;
+
+using diagnostics_container_types = ::testing::Types<
+    diagnostics_container<dingo::static_container_traits<>>,
+    diagnostics_container<dingo::dynamic_container_traits>,
+    diagnostics_container<static_container_with_dynamic_rtti_traits<>>,
+    diagnostics_container<static_container_without_cache<>>,
+    diagnostics_container<dynamic_container_with_static_rtti_traits>,
+    diagnostics_container<dynamic_container_without_cache>>;
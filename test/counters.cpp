@@ -0,0 +1,145 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/counters.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "class.h"
+#include "test.h"
+
+namespace dingo {
+struct counters_container_traits : dynamic_container_traits {
+    template <typename> using rebind_t = counters_container_traits;
+    static constexpr bool counters_enabled = true;
+};
+
+struct counters_single_shard_traits : dynamic_container_traits {
+    template <typename> using rebind_t = counters_single_shard_traits;
+    static constexpr bool counters_enabled = true;
+    static constexpr std::size_t counters_shards = 1;
+};
+
+struct counters_test : public test<void> {};
+
+struct counters_large {
+    counters_large() {}
+    char data[DINGO_CONTEXT_ARENA_BUFFER_SIZE * 2];
+};
+
+struct counters_dependency {
+    counters_dependency(counters_large&&) {}
+};
+
+TEST_F(counters_test, disabled) {
+    container<> container;
+    container.register_type<scope<shared>, storage<Class>>();
+    container.resolve<Class&>();
+
+    auto counters = container.counters();
+    ASSERT_EQ(counters.resolves, 0);
+    ASSERT_EQ(counters.cache_hit_ratio(), 0.0);
+}
+
+TEST_F(counters_test, resolve) {
+    container<counters_container_traits> container;
+    container.register_type<scope<shared>, storage<Class>>();
+    container.register_type<scope<unique>, storage<counters_large>>();
+    container.register_type<scope<unique>, storage<counters_dependency>>();
+
+    container.resolve<Class&>();
+    container.resolve<Class&>();
+    auto counters = container.counters();
+    ASSERT_EQ(counters.resolves, 2);
+    ASSERT_EQ(counters.cache_hits, 1);
+    ASSERT_EQ(counters.cache_misses, 1);
+    ASSERT_EQ(counters.cache_hit_ratio(), 0.5);
+    ASSERT_EQ(counters.arena_spills, 0);
+    ASSERT_EQ(counters.exceptions, 0);
+    ASSERT_EQ(counters.parent_walks, 0);
+
+    ASSERT_THROW(container.resolve<int*>(), type_not_found_exception);
+    ASSERT_EQ(container.counters().resolves, 3);
+    ASSERT_EQ(container.counters().exceptions, 1);
+
+    // Temporary does not fit into the resolving context buffer
+    container.resolve<counters_dependency>();
+    ASSERT_EQ(container.counters().resolves, 4);
+    ASSERT_EQ(container.counters().arena_spills, 1);
+}
+
+TEST_F(counters_test, parent) {
+    using container_type = container<counters_container_traits>;
+
+    container_type parent;
+    parent.register_type<scope<shared>, storage<Class>>();
+
+    container_type::child_container_type<void> child(&parent);
+    child.resolve<Class&>();
+    ASSERT_EQ(child.counters().resolves, 1);
+    ASSERT_EQ(child.counters().parent_walks, 1);
+    ASSERT_EQ(parent.counters().resolves, 0);
+    ASSERT_EQ(parent.counters().cache_misses, 1);
+}
+
+TEST_F(counters_test, threads) {
+    container<counters_container_traits> container;
+    container.register_type<scope<unique>, storage<Class>>();
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < DINGO_COUNTERS_SHARDS + 1; ++i) {
+        threads.emplace_back([&] {
+            for (std::size_t j = 0; j < 100; ++j)
+                container.resolve<Class>();
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    ASSERT_EQ(container.counters().resolves, (DINGO_COUNTERS_SHARDS + 1) * 100);
+}
+
+TEST_F(counters_test, threads_exited) {
+    container<counters_container_traits> container;
+    container.register_type<scope<unique>, storage<Class>>();
+
+    // Shards of exited threads are reused by the following threads
+    for (std::size_t i = 0; i < DINGO_COUNTERS_SHARDS * 2; ++i) {
+        std::thread([&] {
+            for (std::size_t j = 0; j < 100; ++j)
+                container.resolve<Class>();
+        }).join();
+    }
+
+    ASSERT_EQ(container.counters().resolves, DINGO_COUNTERS_SHARDS * 2 * 100);
+}
+
+TEST_F(counters_test, single_shard) {
+    static_assert(sizeof(container_counter<true, 1>) == DINGO_CACHE_LINE_SIZE);
+
+    container<counters_single_shard_traits> container;
+    container.register_type<scope<unique>, storage<Class>>();
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (std::size_t j = 0; j < 100; ++j)
+                container.resolve<Class>();
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    ASSERT_EQ(container.counters().resolves, 400);
+}
+} // namespace dingo
@@ -0,0 +1,180 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/dispatch_table.h>
+#include <dingo/index/array.h>
+#include <dingo/index/map.h>
+#include <dingo/index/unordered_map.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+
+#include "class.h"
+#include "test.h"
+
+namespace dingo {
+template <typename IndexType>
+struct dynamic_container_with_dispatch_index : dynamic_container_traits {
+    using index_definition_type = std::tuple<std::tuple<size_t, IndexType>>;
+};
+
+template <typename IndexType>
+struct static_container_with_dispatch_index : static_container_traits<void> {
+    using index_definition_type = std::tuple<std::tuple<size_t, IndexType>>;
+};
+
+using container_types = ::testing::Types<
+    dingo::container<dynamic_container_with_dispatch_index<index_type::map>>,
+    dingo::container<
+        dynamic_container_with_dispatch_index<index_type::unordered_map>>,
+    dingo::container<
+        dynamic_container_with_dispatch_index<index_type::array<8>>>,
+    dingo::container<
+        static_container_with_dispatch_index<index_type::array<8>>>>;
+
+template <typename T> struct dispatch_table_test : public test<T> {};
+TYPED_TEST_SUITE(dispatch_table_test, container_types, );
+
+TYPED_TEST(dispatch_table_test, shared) {
+    using container_type = TypeParam;
+    container_type container;
+    container.template register_indexed_type<
+        scope<shared>, storage<std::shared_ptr<ClassTag<0>>>,
+        interfaces<IClass>>(size_t(1));
+    container.template register_indexed_type<
+        scope<shared>, storage<std::shared_ptr<ClassTag<1>>>,
+        interfaces<IClass>>(size_t(3));
+
+    auto table =
+        make_dispatch_table<std::shared_ptr<IClass>, size_t>(container);
+    ASSERT_EQ(table.size(), 4);
+    ASSERT_FALSE(table.contains(0));
+    ASSERT_TRUE(table.contains(1));
+    ASSERT_TRUE(table.contains(3));
+
+    // Shared instances are constructed when the table is built
+    ASSERT_EQ(ClassTag<0>::Constructor, 1);
+    ASSERT_EQ(ClassTag<1>::Constructor, 1);
+
+    ASSERT_EQ(table.resolve(1)->GetTag(), 0);
+    ASSERT_EQ(table.resolve(3)->GetTag(), 1);
+    ASSERT_EQ(table.resolve(1),
+              container.template resolve<std::shared_ptr<IClass>>(size_t(1)));
+    ASSERT_EQ(ClassTag<0>::Constructor, 1);
+    ASSERT_EQ(ClassTag<1>::Constructor, 1);
+
+    ASSERT_THROW(table.resolve(0), type_not_found_exception);
+    ASSERT_THROW(table.resolve(4), type_not_found_exception);
+}
+
+TYPED_TEST(dispatch_table_test, unique) {
+    using container_type = TypeParam;
+    container_type container;
+    container.template register_indexed_type<
+        scope<unique>, storage<std::shared_ptr<ClassTag<0>>>,
+        interfaces<IClass>>(size_t(2));
+
+    auto table =
+        make_dispatch_table<std::shared_ptr<IClass>, size_t>(container);
+    ASSERT_EQ(ClassTag<0>::Constructor, 0);
+
+    auto a = table.resolve(2);
+    auto b = table.resolve(2);
+    ASSERT_EQ(a->GetTag(), 0);
+    ASSERT_NE(a, b);
+    ASSERT_EQ(ClassTag<0>::Constructor, 2);
+}
+
+TYPED_TEST(dispatch_table_test, empty) {
+    using container_type = TypeParam;
+    container_type container;
+
+    auto table =
+        make_dispatch_table<std::shared_ptr<IClass>, size_t>(container);
+    ASSERT_EQ(table.size(), 0);
+    ASSERT_THROW(table.resolve(0), type_not_found_exception);
+}
+
+struct dispatch_table_counters_traits : dynamic_container_traits {
+    template <typename> using rebind_t = dispatch_table_counters_traits;
+    static constexpr bool counters_enabled = true;
+    using index_definition_type =
+        std::tuple<std::tuple<size_t, index_type::map>>;
+};
+
+TEST(dispatch_table_test, local) {
+    using container_type = container<dispatch_table_counters_traits>;
+    container_type parent;
+    parent.register_indexed_type<scope<shared>,
+                                 storage<std::shared_ptr<ClassTag<0>>>,
+                                 interfaces<IClass>>(size_t(0));
+
+    container_type::child_container_type<void> child(&parent);
+    ASSERT_EQ(child.resolve<std::shared_ptr<IClass>>(size_t(0))->GetTag(), 0);
+    child.register_indexed_type<scope<shared>,
+                                storage<std::shared_ptr<ClassTag<1>>>,
+                                interfaces<IClass>>(size_t(1));
+    auto resolves = child.counters().resolves;
+
+    // Registrations of the parent are not in the table of the child
+    auto table = make_dispatch_table<std::shared_ptr<IClass>, size_t>(child);
+    ASSERT_FALSE(table.contains(0));
+    ASSERT_TRUE(table.contains(1));
+    ASSERT_THROW(table.resolve(0), type_not_found_exception);
+
+    // Dispatches bypass the container counters
+    ASSERT_EQ(table.resolve(1)->GetTag(), 1);
+    ASSERT_EQ(child.counters().resolves, resolves);
+}
+
+struct dispatch_table_key_traits : dynamic_container_traits {
+    using index_definition_type =
+        std::tuple<std::tuple<uint8_t, index_type::map>,
+                   std::tuple<uint64_t, index_type::map>>;
+};
+
+TEST(dispatch_table_test, max_key) {
+    container<dispatch_table_key_traits> container;
+    container.template register_indexed_type<
+        scope<shared>, storage<std::shared_ptr<ClassTag<0>>>,
+        interfaces<IClass>>(uint8_t(255));
+    container.template register_indexed_type<
+        scope<shared>, storage<std::shared_ptr<ClassTag<1>>>,
+        interfaces<IClass>>(uint8_t(0));
+
+    auto table =
+        make_dispatch_table<std::shared_ptr<IClass>, uint8_t>(container);
+    ASSERT_EQ(table.size(), 256);
+    ASSERT_TRUE(table.contains(255));
+    ASSERT_EQ(table.resolve(255)->GetTag(), 0);
+    ASSERT_EQ(table.resolve(0)->GetTag(), 1);
+}
+
+TEST(dispatch_table_test, sparse_key) {
+    container<dispatch_table_key_traits> container;
+    container.template register_indexed_type<
+        scope<shared>, storage<std::shared_ptr<ClassTag<0>>>,
+        interfaces<IClass>>(uint64_t(1) << 40);
+
+    ASSERT_THROW(
+        (make_dispatch_table<std::shared_ptr<IClass>, uint64_t>(container)),
+        dispatch_table_sparse_exception);
+
+    container.template register_indexed_type<
+        scope<shared>, storage<std::shared_ptr<ClassTag<1>>>,
+        interfaces<IClass>>(std::numeric_limits<uint64_t>::max());
+    ASSERT_THROW(
+        (make_dispatch_table<std::shared_ptr<IClass>, uint64_t>(container)),
+        dispatch_table_sparse_exception);
+}
+
+} // namespace dingo
@@ -0,0 +1,144 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/factory/constructor.h>
+#include <dingo/graph_observer.h>
+#include <dingo/index/map.h>
+#include <dingo/storage/external.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+#include <dingo/type_graph.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "test.h"
+
+namespace dingo {
+struct graph_a {
+    graph_a() {}
+};
+
+struct graph_b {
+    graph_b(graph_a&) {}
+};
+
+struct graph_c {
+    graph_c(graph_b&, graph_a&) {}
+};
+
+struct graph_d {
+    graph_d(int) {}
+};
+
+struct graph_container_traits : dynamic_container_traits {
+    static constexpr bool diagnostics_enabled = true;
+    using observer_type = graph_observer<rtti_type>;
+    using index_definition_type = std::tuple<std::tuple<int, index_type::map>>;
+};
+
+struct graph_test : public test<void> {};
+
+template <typename T> const type_graph::node* find_node(const type_graph& graph) {
+    for (auto& node : graph.nodes) {
+        if (node.interface == type_name<T>())
+            return &node;
+    }
+    return nullptr;
+}
+
+template <typename From, typename To>
+const type_graph::edge* find_edge(const type_graph& graph) {
+    for (auto& edge : graph.edges) {
+        if (edge.from == type_name<From>() && edge.to == type_name<To>())
+            return &edge;
+    }
+    return nullptr;
+}
+
+TEST_F(graph_test, registrations) {
+    container<diagnostics_container_traits<dynamic_container_traits>>
+        container;
+    container.register_type<scope<shared>, storage<graph_a>>();
+    container.register_type<scope<unique>, storage<graph_b>,
+                            factory<constructor<graph_b(graph_a&)>>>();
+    container.register_type<scope<unique>, storage<std::unique_ptr<graph_c>>>();
+    container.register_type<scope<unique>, storage<graph_d>>()
+        .register_type<scope<external>, storage<int>>(1);
+
+    auto graph = container.graph();
+    ASSERT_EQ(graph.containers.size(), 2);
+    ASSERT_FALSE(graph.containers[0].parent);
+    ASSERT_EQ(graph.containers[1].parent, 0);
+    ASSERT_EQ(graph.nodes.size(), 5);
+
+    auto a = find_node<graph_a>(graph);
+    ASSERT_TRUE(a);
+    ASSERT_EQ(a->scope, type_name<shared>());
+    ASSERT_EQ(a->storage, type_name<graph_a>());
+    ASSERT_EQ(a->arity, 0);
+    ASSERT_EQ(a->container, 0);
+
+    auto c = find_node<graph_c>(graph);
+    ASSERT_TRUE(c);
+    ASSERT_EQ(c->storage, type_name<std::unique_ptr<graph_c>>());
+    ASSERT_EQ(c->arity, 2);
+
+    auto d = find_node<graph_d>(graph);
+    ASSERT_TRUE(d);
+    ASSERT_EQ(graph.containers[1].registration,
+              static_cast<std::size_t>(d - graph.nodes.data()));
+    auto i = find_node<int>(graph);
+    ASSERT_TRUE(i);
+    ASSERT_EQ(i->container, 1);
+    ASSERT_EQ(i->scope, type_name<external>());
+
+    // Constructor with explicit arguments
+    auto b_a = find_edge<graph_b, graph_a>(graph);
+    ASSERT_TRUE(b_a);
+    ASSERT_FALSE(b_a->observed);
+    ASSERT_EQ(graph.edges.size(), 1);
+}
+
+TEST_F(graph_test, observed) {
+    using container_type = container<graph_container_traits>;
+
+    container_type container;
+    container.register_type<scope<shared>, storage<graph_a>>();
+    container.register_type<scope<unique>, storage<graph_b>,
+                            factory<constructor<graph_b(graph_a&)>>>();
+    container.register_indexed_type<scope<unique>, storage<graph_c>>(1);
+    container.resolve<graph_c>(1);
+
+    auto graph =
+        container.graph<container_type::observer_type>();
+    ASSERT_TRUE(find_node<graph_c>(graph)->indexed);
+    ASSERT_FALSE(find_node<graph_b>(graph)->indexed);
+
+    ASSERT_TRUE((find_edge<graph_b, graph_a>(graph)->observed));
+    ASSERT_TRUE((find_edge<graph_c, graph_b>(graph)->observed));
+    ASSERT_TRUE((find_edge<graph_c, graph_a>(graph)->observed));
+    ASSERT_EQ(graph.edges.size(), 3);
+
+    std::stringstream dot;
+    graph.write_dot(dot);
+    ASSERT_NE(dot.str().find("digraph dingo {"), std::string::npos);
+    ASSERT_NE(dot.str().find("\"" + std::string(type_name<graph_c>()) +
+                             "\" -> \"" + std::string(type_name<graph_b>()) +
+                             "\";"),
+              std::string::npos);
+
+    std::stringstream json;
+    graph.write_json(json);
+    ASSERT_NE(json.str().find("\"interface\":\"" +
+                              std::string(type_name<graph_c>()) + "\""),
+              std::string::npos);
+    ASSERT_NE(json.str().find("\"indexed\":true"), std::string::npos);
+}
+} // namespace dingo
@@ -37,6 +37,22 @@ struct dynamic_container_with_index {
     static constexpr bool cache_enabled = true;
 };
 
+template <typename Tag, typename IndexKey, typename IndexType>
+struct static_container_with_index {
+    template <typename TagT>
+    using rebind_t = static_container_with_index<TagT, IndexKey, IndexType>;
+
+    using tag_type = Tag;
+    using rtti_type = dingo::rtti<dingo::static_provider>;
+    template <typename Value, typename Allocator>
+    using type_map_type = dingo::static_type_map<Value, Tag, Allocator>;
+    template <typename Value, typename Allocator>
+    using type_cache_type = dingo::static_type_cache<void*, Tag, Allocator>;
+    using allocator_type = dingo::static_pool_allocator<char, Tag>;
+    using index_definition_type = std::tuple<std::tuple<IndexKey, IndexType>>;
+    static constexpr bool cache_enabled = true;
+};
+
 using container_types = ::testing::Types<
     dingo::container<dingo::dynamic_container_with_index<int, index_type::map>>,
     dingo::container<
@@ -48,7 +64,11 @@ using container_types = ::testing::Types<
     dingo::container<
         dingo::dynamic_container_with_index<size_t, index_type::map>>,
     dingo::container<
-        dingo::dynamic_container_with_index<size_t, index_type::array<32>>>>;
+        dingo::dynamic_container_with_index<size_t, index_type::array<32>>>,
+    dingo::container<
+        dingo::static_container_with_index<void, int, index_type::map>>,
+    dingo::container<dingo::static_container_with_index<
+        void, size_t, index_type::array<32>>>>;
 
 template <typename T> struct index_test : public test<T> {};
 TYPED_TEST_SUITE(index_test, container_types, );
@@ -0,0 +1,198 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/index/map.h>
+#include <dingo/memory_resource.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+
+#include <gtest/gtest.h>
+
+#include "assert.h"
+#include "class.h"
+#include "test.h"
+
+namespace dingo {
+struct counting_memory_resource : std::pmr::memory_resource {
+    std::size_t allocated = 0;
+    std::size_t allocations = 0;
+
+  private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        allocated += bytes;
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes,
+                       std::size_t alignment) override {
+        allocated -= bytes;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Sets the default resource for the scope, so it is restored when an assertion
+// returns from the test
+struct default_memory_resource_guard {
+    default_memory_resource_guard(std::pmr::memory_resource* resource)
+        : previous_(std::pmr::set_default_resource(resource)) {}
+    ~default_memory_resource_guard() {
+        std::pmr::set_default_resource(previous_);
+    }
+
+  private:
+    std::pmr::memory_resource* previous_;
+};
+
+template <typename T> struct memory_resource_test : public test<T> {};
+using memory_resource_container_types =
+    ::testing::Types<pmr::container<>,
+                     pmr::container<std::tuple<std::tuple<int, index_type::map>>>>;
+TYPED_TEST_SUITE(memory_resource_test, memory_resource_container_types, );
+
+TYPED_TEST(memory_resource_test, accounting) {
+    using container_type = TypeParam;
+
+    counting_memory_resource resource;
+    {
+        container_type container(&resource);
+        container.template register_type<scope<shared>, storage<Class>,
+                                         interfaces<Class, IClass>>();
+        container.template register_type<scope<unique>,
+                                         storage<std::unique_ptr<ClassTag<1>>>>();
+        ASSERT_GT(resource.allocated, 0);
+
+        container.template resolve<IClass&>();
+        container.template resolve<std::unique_ptr<ClassTag<1>>>();
+    }
+
+    ASSERT_GT(resource.allocations, 0);
+    ASSERT_EQ(resource.allocated, 0);
+}
+
+TYPED_TEST(memory_resource_test, buffer) {
+    using container_type = TypeParam;
+
+    // All container memory comes from the buffer, null_memory_resource throws
+    // if the buffer is exhausted or another resource is used
+    alignas(std::max_align_t) uint8_t buffer[1 << 14];
+    std::pmr::monotonic_buffer_resource resource(
+        buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    default_memory_resource_guard guard(std::pmr::null_memory_resource());
+
+    {
+        container_type container(&resource);
+        container.template register_type<scope<shared>, storage<Class>,
+                                         interfaces<Class, IClass>>();
+        container.template register_type<scope<unique>, storage<ClassTag<1>>>();
+        AssertClass(container.template resolve<IClass&>());
+        container.template resolve<ClassTag<1>>();
+
+        // Child container uses resource of the parent
+        typename container_type::template child_container_type<void> child(
+            &container);
+        child.template register_type<scope<shared>, storage<ClassTag<2>>>();
+        child.template resolve<ClassTag<2>&>();
+        AssertClass(child.template resolve<Class&>());
+    }
+}
+
+struct memory_resource_dependent {
+    // Unique dependency is a temporary kept by the resolving context
+    memory_resource_dependent(ClassTag<1> cls) : tag(cls.GetTag()) {}
+    std::size_t tag;
+};
+
+TYPED_TEST(memory_resource_test, null_upstream) {
+    using container_type = TypeParam;
+
+    // Resolving contexts, closures and conversions are allocated from the
+    // resource
+    alignas(std::max_align_t) uint8_t buffer[1 << 16];
+    std::pmr::monotonic_buffer_resource resource(
+        buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    default_memory_resource_guard guard(std::pmr::null_memory_resource());
+
+    {
+        container_type container(&resource);
+        container.template register_type<scope<shared>, storage<Class>,
+                                         interfaces<Class, IClass>>();
+        container.template register_type<scope<unique>, storage<ClassTag<1>>>();
+        container.template register_type<scope<shared>,
+                                         storage<memory_resource_dependent>>();
+        container.template register_type<scope<shared>, storage<ClassTag<2>>,
+                                         interfaces<IClass1, IClass2>>();
+
+        AssertClass(container.template resolve<IClass&>());
+        AssertClass(container.template resolve<Class*>());
+        container.template resolve<ClassTag<1>>();
+        ASSERT_EQ(
+            container.template resolve<memory_resource_dependent&>().tag, 1);
+        ASSERT_EQ(container.template resolve<IClass1&>().GetTag(), 2);
+        ASSERT_EQ(container.template resolve<IClass2*>()->GetTag(), 2);
+    }
+}
+
+struct memory_resource_large_temporary {
+    memory_resource_large_temporary() {}
+    char data[1024];
+};
+
+struct memory_resource_large_class {
+    memory_resource_large_class(memory_resource_large_temporary&& a,
+                                memory_resource_large_temporary&& b)
+        : value(a.data[0] + b.data[0]) {}
+    int value;
+};
+
+TYPED_TEST(memory_resource_test, arena_upstream) {
+    using container_type = TypeParam;
+
+    counting_memory_resource resource;
+    {
+        container_type container(&resource);
+        container.template register_type<
+            scope<unique>, storage<memory_resource_large_temporary>>();
+        container.template register_type<scope<unique>,
+                                         storage<memory_resource_large_class>>();
+
+        // Temporaries spilling out of the context buffer are placed into
+        // blocks from the resource, released when the resolution ends
+        std::size_t allocated = resource.allocated;
+        std::size_t allocations = resource.allocations;
+        container.template resolve<memory_resource_large_class>();
+        ASSERT_GT(resource.allocations, allocations);
+        ASSERT_EQ(resource.allocated, allocated);
+    }
+    ASSERT_EQ(resource.allocated, 0);
+}
+
+TEST(memory_resource, index) {
+    counting_memory_resource resource;
+    {
+        pmr::container<std::tuple<std::tuple<int, index_type::map>>> container(
+            &resource);
+        container.register_indexed_type<scope<shared>,
+                                        storage<std::shared_ptr<Class>>,
+                                        interfaces<IClass>>(1);
+        std::size_t allocations = resource.allocations;
+        container.register_indexed_type<scope<shared>,
+                                        storage<std::shared_ptr<ClassTag<1>>>,
+                                        interfaces<IClass>>(2);
+        ASSERT_GT(resource.allocations, allocations);
+        ASSERT_EQ(container.resolve<std::shared_ptr<IClass>>(2)->GetTag(), 1);
+    }
+    ASSERT_EQ(resource.allocated, 0);
+}
+
+} // namespace dingo
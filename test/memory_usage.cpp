@@ -0,0 +1,120 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/index/map.h>
+#include <dingo/storage/external.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+
+#include <gtest/gtest.h>
+
+#include "class.h"
+#include "containers.h"
+#include "test.h"
+
+namespace dingo {
+template <typename T> struct memory_usage_test : public test<T> {};
+TYPED_TEST_SUITE(memory_usage_test, diagnostics_container_types, );
+
+TYPED_TEST(memory_usage_test, empty) {
+    using container_type = TypeParam;
+    container_type container;
+
+    auto usage = container.memory_usage();
+    ASSERT_EQ(usage.containers, sizeof(container_type));
+    ASSERT_EQ(usage.total(), sizeof(container_type));
+}
+
+TYPED_TEST(memory_usage_test, registrations) {
+    using container_type = TypeParam;
+
+    struct A {
+        A() {}
+        char buffer[256];
+    };
+
+    container_type container;
+    container.template register_type<scope<unique>, storage<Class>>();
+    auto unique_usage = container.memory_usage();
+    ASSERT_GT(unique_usage.type_factories, 0);
+    ASSERT_GT(unique_usage.factories, 0);
+
+    container.template register_type<scope<shared>, storage<A>>();
+    auto shared_usage = container.memory_usage();
+    ASSERT_GE(shared_usage.storages - unique_usage.storages, sizeof(A));
+    ASSERT_GT(shared_usage.type_factories, unique_usage.type_factories);
+
+    // Nested container is accounted once it is created
+    container.template register_type<scope<shared>, storage<ClassTag<1>>>()
+        .template register_type<scope<external>, storage<int>>(1);
+    auto nested_usage = container.memory_usage();
+    ASSERT_GT(nested_usage.containers, shared_usage.containers);
+    ASSERT_GT(nested_usage.total(), shared_usage.total());
+}
+
+TYPED_TEST(memory_usage_test, closures) {
+    using container_type = TypeParam;
+
+    struct B : ClassTag<1> {
+        B(Class c) : c_(std::move(c)) {}
+        Class c_;
+    };
+
+    container_type container;
+    container.template register_type<scope<unique>, storage<Class>>();
+    container.template register_type<scope<shared>, storage<B>>();
+    container.template register_type<scope<shared>, storage<ClassTag<2>>>();
+    ASSERT_EQ(container.memory_usage().closures, 0);
+
+    // Closure without temporaries is released after the construction
+    container.template resolve<ClassTag<2>&>();
+    ASSERT_EQ(container.memory_usage().closures, 0);
+
+    // Closure holding the temporary is kept, small temporaries fit into its
+    // inline buffer
+    container.template resolve<B&>();
+    ASSERT_GT(container.memory_usage().closures, 0);
+    ASSERT_LT(container.memory_usage().closures,
+              arena_allocator_traits<std::allocator<uint8_t>>::page_size());
+}
+
+TYPED_TEST(memory_usage_test, conversions) {
+    using container_type = TypeParam;
+
+    container_type container;
+    container.template register_type<scope<shared>,
+                                     storage<std::shared_ptr<ClassTag<0>>>,
+                                     interfaces<IClass, ClassTag<0>>>();
+    auto usage = container.memory_usage();
+
+    // Conversion is allocated only when requested
+    container.template resolve<IClass&>();
+    ASSERT_EQ(container.memory_usage().conversions, usage.conversions);
+    container.template resolve<std::shared_ptr<IClass>&>();
+    ASSERT_EQ(container.memory_usage().conversions,
+              usage.conversions + sizeof(std::shared_ptr<IClass>));
+}
+
+TEST(memory_usage, index) {
+    struct container_traits : dynamic_container_traits {
+        using index_definition_type =
+            std::tuple<std::tuple<int, index_type::map>>;
+    };
+
+    container<diagnostics_container_traits<container_traits>> container;
+    container.register_indexed_type<scope<shared>, storage<ClassTag<0>>,
+                                    interfaces<IClass>>(1);
+    auto usage = container.memory_usage();
+    ASSERT_GT(usage.indexes, 0);
+
+    container.register_indexed_type<scope<shared>, storage<ClassTag<1>>,
+                                    interfaces<IClass>>(2);
+    ASSERT_GT(container.memory_usage().indexes, usage.indexes);
+}
+
+} // namespace dingo
@@ -109,4 +109,33 @@ TEST(nesting_test, child_container_dynamic) {
     ASSERT_EQ(b.a.value, 42);
 }
 
+TYPED_TEST(nesting_test, type_on_demand) {
+    using container_type = TypeParam;
+
+    struct A {
+        int value;
+    };
+
+    struct B {
+        int value;
+    };
+
+    container_type container;
+    container.template register_type<scope<external>, storage<int>>(42);
+
+    // Nested container is created only when something is registered into it
+    auto& nested_a =
+        container.template register_type<scope<unique>, storage<A>>();
+    ASSERT_FALSE(nested_a.has_container());
+    ASSERT_EQ(container.template resolve<A>().value, 42);
+    ASSERT_FALSE(nested_a.has_container());
+
+    auto& nested_b =
+        container.template register_type<scope<unique>, storage<B>>();
+    nested_b.template register_type<scope<external>, storage<int>>(4);
+    ASSERT_TRUE(nested_b.has_container());
+    ASSERT_EQ(container.template resolve<B>().value, 4);
+    ASSERT_EQ(container.template resolve<A>().value, 42);
+}
+
 } // namespace dingo
@@ -0,0 +1,174 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/factory/constructor.h>
+#include <dingo/observer.h>
+#include <dingo/storage/external.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "class.h"
+#include "test.h"
+
+namespace dingo {
+using observer_rtti = rtti<typeid_provider>;
+
+struct observer_event {
+    enum kind {
+        resolve_begin,
+        resolve_end,
+        cache_hit,
+        cache_miss,
+        factory_invoke,
+        construct,
+        destroy
+    };
+
+    kind event;
+    observer_rtti::type_index type;
+
+    bool operator==(const observer_event& other) const {
+        return event == other.event && type == other.type;
+    }
+};
+
+template <typename T>
+observer_event make_event(observer_event::kind event) {
+    return {event, observer_rtti::get_type_index<T>()};
+}
+
+struct recording_observer : null_observer {
+    using type_index = observer_rtti::type_index;
+
+    static void on_resolve_begin(const type_index& type) {
+        events.push_back({observer_event::resolve_begin, type});
+    }
+    static void on_resolve_end(const type_index& type) {
+        events.push_back({observer_event::resolve_end, type});
+    }
+    static void on_cache_hit(const type_index& type) {
+        events.push_back({observer_event::cache_hit, type});
+    }
+    static void on_cache_miss(const type_index& type) {
+        events.push_back({observer_event::cache_miss, type});
+    }
+    static void on_factory_invoke(const type_index& type, const type_index&) {
+        events.push_back({observer_event::factory_invoke, type});
+    }
+    static void on_construct(const type_index& type, const type_index& scope) {
+        events.push_back({observer_event::construct, type});
+        scopes.push_back(scope);
+    }
+    static void on_destroy(const type_index& type, const type_index&) {
+        events.push_back({observer_event::destroy, type});
+    }
+
+    static std::vector<observer_event> events;
+    static std::vector<type_index> scopes;
+};
+
+std::vector<observer_event> recording_observer::events;
+std::vector<observer_rtti::type_index> recording_observer::scopes;
+
+struct observer_container_traits : dynamic_container_traits {
+    using observer_type = recording_observer;
+};
+
+struct observer_test : public test<void> {
+    void SetUp() override {
+        test<void>::SetUp();
+        recording_observer::events.clear();
+        recording_observer::scopes.clear();
+    }
+};
+
+TEST_F(observer_test, null_observer) {
+    static_assert(std::is_same_v<container<>::observer_type, null_observer>);
+    static_assert(!is_observer_enabled_v<container<>::observer_type>);
+    static_assert(
+        std::is_empty_v<resolve_observer_guard<null_observer, observer_rtti,
+                                               Class>>);
+}
+
+TEST_F(observer_test, unique) {
+    using E = observer_event;
+    {
+        container<observer_container_traits> container;
+        container.register_type<scope<unique>, storage<Class>>();
+        container.resolve<Class>();
+    }
+
+    std::vector<observer_event> expected = {
+        make_event<Class>(E::resolve_begin),
+        make_event<Class>(E::cache_miss),
+        make_event<Class>(E::factory_invoke),
+        make_event<Class>(E::construct),
+        make_event<Class>(E::resolve_end),
+    };
+    ASSERT_EQ(recording_observer::events, expected);
+    ASSERT_EQ(recording_observer::scopes.front(),
+              observer_rtti::get_type_index<unique>());
+}
+
+struct observer_dependency {
+    observer_dependency(Class&) {}
+};
+
+TEST_F(observer_test, shared) {
+    using E = observer_event;
+    {
+        container<observer_container_traits> container;
+        container.register_type<scope<shared>, storage<Class>>();
+        container.register_type<scope<unique>, storage<observer_dependency>>();
+        container.resolve<observer_dependency>();
+        container.resolve<Class&>();
+    }
+
+    std::vector<observer_event> expected = {
+        make_event<observer_dependency>(E::resolve_begin),
+        make_event<observer_dependency>(E::cache_miss),
+        make_event<observer_dependency>(E::factory_invoke),
+        make_event<Class>(E::resolve_begin),
+        make_event<Class>(E::cache_miss),
+        make_event<Class>(E::factory_invoke),
+        make_event<Class>(E::construct),
+        make_event<Class>(E::resolve_end),
+        make_event<observer_dependency>(E::construct),
+        make_event<observer_dependency>(E::resolve_end),
+        make_event<Class>(E::resolve_begin),
+        make_event<Class>(E::cache_hit),
+        make_event<Class>(E::resolve_end),
+        make_event<Class>(E::destroy),
+    };
+    ASSERT_EQ(recording_observer::events, expected);
+    ASSERT_EQ(recording_observer::scopes.front(),
+              observer_rtti::get_type_index<shared>());
+}
+
+TEST_F(observer_test, external) {
+    using E = observer_event;
+    {
+        Class c;
+        container<observer_container_traits> container;
+        container.register_type<scope<external>, storage<Class&>>(c);
+        container.resolve<Class&>();
+    }
+
+    std::vector<observer_event> expected = {
+        make_event<Class>(E::resolve_begin),
+        make_event<Class>(E::cache_miss),
+        make_event<Class>(E::factory_invoke),
+        make_event<Class>(E::resolve_end),
+    };
+    ASSERT_EQ(recording_observer::events, expected);
+}
+} // namespace dingo
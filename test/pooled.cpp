@@ -0,0 +1,202 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/storage/pooled.h>
+#include <dingo/storage/shared.h>
+
+#include <gtest/gtest.h>
+
+#include "assert.h"
+#include "class.h"
+#include "containers.h"
+#include "test.h"
+
+namespace dingo {
+struct PooledBuffer {
+    PooledBuffer() {}
+
+    size_t size = 0;
+    static size_t Resets;
+};
+
+size_t PooledBuffer::Resets;
+
+template <> struct pool_traits<PooledBuffer> {
+    static constexpr std::size_t capacity = 2;
+    static void reset(PooledBuffer& buffer) {
+        buffer.size = 0;
+        ++PooledBuffer::Resets;
+    }
+};
+
+template <typename T> struct pooled_test : public test<T> {
+    void SetUp() override {
+        test<T>::SetUp();
+        PooledBuffer::Resets = 0;
+    }
+};
+TYPED_TEST_SUITE(pooled_test, container_types, );
+
+TYPED_TEST(pooled_test, recycle) {
+    using container_type = TypeParam;
+
+    {
+        container_type container;
+        container.template register_type<scope<pooled>, storage<Class>>();
+
+        {
+            auto c = container.template resolve<pooled_ptr<Class>>();
+            AssertClass(*c);
+            ASSERT_EQ(Class::Constructor, 1);
+        }
+
+        // The instance was returned to the pool and is reused
+        for (size_t i = 0; i < 10; ++i) {
+            auto c = container.template resolve<pooled_ptr<Class>>();
+            AssertClass(*c);
+        }
+        ASSERT_EQ(Class::Constructor, 1);
+        ASSERT_EQ(Class::CopyConstructor, 0);
+        ASSERT_EQ(Class::MoveConstructor, 0);
+        ASSERT_EQ(Class::Destructor, 0);
+
+        {
+            auto a = container.template resolve<pooled_ptr<Class>>();
+            auto b = container.template resolve<pooled_ptr<Class>>();
+            ASSERT_NE(a.get(), b.get());
+            ASSERT_EQ(Class::Constructor, 2);
+        }
+        ASSERT_EQ(Class::Destructor, 0);
+    }
+
+    ASSERT_EQ(Class::Destructor, Class::GetTotalInstances());
+}
+
+TYPED_TEST(pooled_test, interface) {
+    using container_type = TypeParam;
+
+    {
+        container_type container;
+        container.template register_type<scope<pooled>, storage<Class>,
+                                         interfaces<IClass, Class>>();
+
+        IClass* ptr = nullptr;
+        {
+            auto c = container.template resolve<pooled_ptr<IClass>>();
+            AssertClass(*c);
+            ptr = c.get();
+        }
+        {
+            auto c = container.template resolve<pooled_ptr<Class>>();
+            ASSERT_EQ(static_cast<IClass*>(c.get()), ptr);
+        }
+        ASSERT_EQ(Class::Constructor, 1);
+
+        AssertTypeNotConvertible<Class, type_list<Class*, Class&>>(container);
+    }
+
+    ASSERT_EQ(Class::Destructor, Class::GetTotalInstances());
+}
+
+TYPED_TEST(pooled_test, reset_hook) {
+    using container_type = TypeParam;
+
+    container_type container;
+    container.template register_type<scope<pooled>, storage<PooledBuffer>>();
+
+    {
+        auto buffer = container.template resolve<pooled_ptr<PooledBuffer>>();
+        buffer->size = 10;
+    }
+    ASSERT_EQ(PooledBuffer::Resets, 1);
+    ASSERT_EQ(container.template resolve<pooled_ptr<PooledBuffer>>()->size,
+              0);
+    ASSERT_EQ(PooledBuffer::Resets, 2);
+}
+
+TYPED_TEST(pooled_test, exhausted) {
+    using container_type = TypeParam;
+
+    struct A : ClassTag<1> {};
+
+    {
+        container_type container;
+        container.template register_type<scope<pooled>, storage<A>>();
+
+        {
+            std::vector<pooled_ptr<A>> instances;
+            for (size_t i = 0; i < DINGO_POOLED_STORAGE_CAPACITY + 2; ++i)
+                instances.push_back(container.template resolve<pooled_ptr<A>>());
+            ASSERT_EQ(A::Constructor, DINGO_POOLED_STORAGE_CAPACITY + 2);
+        }
+
+        // Instances that did not fit into the pool were destroyed
+        ASSERT_EQ(A::Destructor, 2);
+    }
+
+    ASSERT_EQ(A::Destructor, A::GetTotalInstances());
+}
+
+TYPED_TEST(pooled_test, outlive_container) {
+    using container_type = TypeParam;
+
+    struct A : ClassTag<1> {};
+
+    pooled_ptr<A> a;
+    pooled_ptr<A> overflow;
+    {
+        container_type container;
+        container.template register_type<scope<pooled>, storage<A>>();
+
+        std::vector<pooled_ptr<A>> instances;
+        for (size_t i = 0; i < DINGO_POOLED_STORAGE_CAPACITY; ++i)
+            instances.push_back(container.template resolve<pooled_ptr<A>>());
+        a = std::move(instances.back());
+        instances.pop_back();
+        overflow = container.template resolve<pooled_ptr<A>>();
+    }
+
+    // Instances returned to the pool were destroyed with the container
+    ASSERT_EQ(A::Destructor, DINGO_POOLED_STORAGE_CAPACITY - 1);
+
+    // Handles are usable after the container is destroyed
+    AssertClass(*a);
+    ASSERT_EQ(a->GetTag(), 1);
+    a.reset();
+    ASSERT_EQ(A::Destructor, DINGO_POOLED_STORAGE_CAPACITY);
+    overflow.reset();
+    ASSERT_EQ(A::Destructor, A::GetTotalInstances());
+}
+
+TYPED_TEST(pooled_test, dependency) {
+    using container_type = TypeParam;
+
+    struct A : ClassTag<1> {};
+    struct B : ClassTag<2> {
+        B(A& a) : a_(a) {}
+        A& a_;
+    };
+
+    container_type container;
+    container.template register_type<scope<shared>, storage<A>>();
+    container.template register_type<scope<pooled>, storage<B>>();
+
+    A* a = nullptr;
+    {
+        auto b = container.template resolve<pooled_ptr<B>>();
+        a = &b->a_;
+    }
+    {
+        auto b = container.template resolve<pooled_ptr<B>>();
+        ASSERT_EQ(&b->a_, a);
+    }
+    ASSERT_EQ(B::Constructor, 1);
+    ASSERT_EQ(A::Constructor, 1);
+}
+
+} // namespace dingo
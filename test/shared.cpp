@@ -8,9 +8,13 @@
 #include <dingo/container.h>
 #include <dingo/factory/constructor.h>
 #include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "assert.h"
 #include "class.h"
 #include "containers.h"
@@ -391,4 +395,169 @@ TYPED_TEST(shared_test, ambiguous_resolve) {
         4);
 }
 
+TYPED_TEST(shared_test, temporary_argument) {
+    using container_type = TypeParam;
+
+    struct B : ClassTag<1> {
+        B(Class c) : c_(std::move(c)) {}
+        Class c_;
+    };
+
+    {
+        container_type container;
+        container.template register_type<scope<unique>, storage<Class>>();
+        container.template register_type<scope<shared>, storage<B>>();
+
+        // The temporary is placed in the closure of B and remains valid
+        // after the construction
+        auto& b = container.template resolve<B&>();
+        AssertClass(b.c_);
+        ASSERT_EQ(&container.template resolve<B&>(), &b);
+        ASSERT_EQ(B::Constructor, 1);
+        ASSERT_EQ(Class::Constructor, 1);
+    }
+
+    ASSERT_EQ(B::Destructor, B::GetTotalInstances());
+}
+
+TYPED_TEST(shared_test, resolve_view) {
+    using container_type = TypeParam;
+
+    {
+        container_type container;
+        container.template register_type<scope<shared>, storage<Class>>();
+        container.template register_type<scope<unique>, storage<ClassTag<1>>>();
+
+        const Class& c = container.template resolve_view<Class>();
+        AssertClass(c);
+        ASSERT_EQ(&container.template resolve_view<Class>(), &c);
+        ASSERT_EQ(Class::CopyConstructor, 0);
+
+        ASSERT_THROW(container.template resolve_view<ClassTag<1>>(),
+                     type_not_convertible_exception);
+    }
+
+    ASSERT_EQ(Class::Destructor, Class::GetTotalInstances());
+}
+
+TYPED_TEST(shared_test, isolated) {
+    using container_type = TypeParam;
+
+    {
+        container_type container;
+        container.template register_type<scope<shared_isolated>,
+                                         storage<Class>,
+                                         interfaces<Class, IClass>>();
+        container.template register_type<scope<shared_isolated>,
+                                         storage<ClassTag<1>>>();
+
+        auto& c = container.template resolve<Class&>();
+        AssertClass(c);
+        ASSERT_EQ(&container.template resolve<IClass&>(),
+                  static_cast<IClass*>(&c));
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(&c) % DINGO_CACHE_LINE_SIZE, 0);
+
+        auto& c1 = container.template resolve<ClassTag<1>&>();
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(&c1) % DINGO_CACHE_LINE_SIZE, 0);
+        ASSERT_EQ(Class::Constructor, 1);
+    }
+
+    ASSERT_EQ(Class::Destructor, Class::GetTotalInstances());
+}
+
+struct finalize_a {
+    finalize_a() {}
+    int value = 1;
+};
+
+struct finalize_b {
+    finalize_b(finalize_a& a) : a_(a) {}
+    finalize_a& a_;
+};
+
+struct finalize_c {
+    finalize_c(finalize_b& b, Class& c) : b_(b), c_(c) {}
+    finalize_b& b_;
+    Class& c_;
+};
+
+TYPED_TEST(shared_test, finalize) {
+    using container_type = TypeParam;
+
+    {
+        container_type container;
+        container.template register_type<scope<shared>, storage<finalize_c>>();
+        container.template register_type<scope<shared>, storage<Class>>();
+        container.template register_type<scope<shared>, storage<finalize_a>>();
+        container.template register_type<scope<shared>, storage<finalize_b>>();
+        container.template register_type<scope<unique>, storage<ClassTag<1>>>();
+
+        auto& a = container.template resolve<finalize_a&>();
+        container.finalize();
+        ASSERT_EQ(Class::Constructor, 1);
+
+        auto& b = container.template resolve<finalize_b&>();
+        auto& c = container.template resolve<finalize_c&>();
+        ASSERT_EQ(&b.a_, &a);
+        ASSERT_EQ(&c.b_, &b);
+        ASSERT_EQ(&c.c_, &container.template resolve<Class&>());
+        ASSERT_EQ(Class::Constructor, 1);
+
+        // Instances constructed by finalize() are adjacent, static containers
+        // can not allocate the region and keep them in their storages
+        if constexpr (is_array_allocator<
+                          typename container_type::allocator_type>::value) {
+            auto first = std::min({reinterpret_cast<uintptr_t>(&b),
+                                   reinterpret_cast<uintptr_t>(&c),
+                                   reinterpret_cast<uintptr_t>(&c.c_)});
+            auto last = std::max({reinterpret_cast<uintptr_t>(&b),
+                                  reinterpret_cast<uintptr_t>(&c),
+                                  reinterpret_cast<uintptr_t>(&c.c_)});
+            ASSERT_LT(last - first,
+                      sizeof(finalize_b) + sizeof(finalize_c) + sizeof(Class) +
+                          3 * alignof(std::max_align_t));
+        }
+    }
+
+    ASSERT_EQ(Class::Destructor, Class::GetTotalInstances());
+}
+
+template <typename ValueCopyPolicy>
+struct value_copy_container_traits : dynamic_container_traits {
+    using value_copy_policy = ValueCopyPolicy;
+};
+
+struct value_copy_config {
+    value_copy_config() {}
+    std::vector<int> values;
+};
+
+TEST(shared_value_copy_test, count) {
+    container<value_copy_container_traits<value_copy::count>> container;
+    container.register_type<scope<shared>, storage<value_copy_config>>();
+    container.register_type<scope<shared>, storage<std::shared_ptr<int>>>();
+    container.register_type<scope<unique>, storage<Class>>();
+
+    container.resolve<value_copy_config&>();
+    container.resolve<std::shared_ptr<int>>();
+    container.resolve<Class>();
+    ASSERT_EQ(container.value_copies(), 0);
+
+    container.resolve<value_copy_config>();
+    container.resolve<value_copy_config>();
+    ASSERT_EQ(container.value_copies(), 2);
+}
+
+TEST(shared_value_copy_test, forbid) {
+    container<value_copy_container_traits<value_copy::forbid>> container;
+    container.register_type<scope<shared>, storage<value_copy_config>>();
+    container.register_type<scope<unique>, storage<Class>>();
+
+    ASSERT_NO_THROW(container.resolve<value_copy_config&>());
+    ASSERT_NO_THROW(container.resolve_view<value_copy_config>());
+    ASSERT_NO_THROW(container.resolve<Class>());
+    ASSERT_THROW(container.resolve<value_copy_config>(),
+                 type_value_copy_exception);
+}
+
 } // namespace dingo
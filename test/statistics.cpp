@@ -0,0 +1,93 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/factory/constructor.h>
+#include <dingo/statistics.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "class.h"
+#include "test.h"
+
+namespace dingo {
+template <typename Tag>
+struct statistics_container_traits : dynamic_container_traits {
+    using observer_type = statistics_observer<rtti_type, Tag>;
+};
+
+struct statistics_test : public test<void> {};
+
+struct statistics_dependency {
+    statistics_dependency(Class&, const std::string&) {}
+};
+
+TEST_F(statistics_test, types) {
+    using container_type = container<statistics_container_traits<int>>;
+    using observer_type = container_type::observer_type;
+
+    container_type container;
+    container.register_type<scope<shared>, storage<Class>>();
+    container.register_type<scope<unique>, storage<statistics_dependency>>();
+    container.register_type<scope<unique>, storage<std::string>>(
+        callable([] { return std::string("temporary"); }));
+
+    container.resolve<statistics_dependency>();
+    container.resolve<statistics_dependency>();
+    container.resolve<Class&>();
+
+    auto shared = observer_type::statistics<Class>();
+    ASSERT_EQ(shared.resolves, 3);
+    ASSERT_EQ(shared.cache_hits, 2);
+    ASSERT_EQ(shared.cache_misses, 1);
+    ASSERT_EQ(shared.constructions, 1);
+#if DINGO_ARENA_STATISTICS
+    ASSERT_EQ(shared.temporaries, 0);
+#endif
+    ASSERT_EQ(shared.max_construction_time, shared.construction_time);
+
+    auto unique = observer_type::statistics<statistics_dependency>();
+    ASSERT_EQ(unique.resolves, 2);
+    ASSERT_EQ(unique.cache_hits, 0);
+    ASSERT_EQ(unique.cache_misses, 2);
+    ASSERT_EQ(unique.constructions, 2);
+#if DINGO_ARENA_STATISTICS
+    ASSERT_GE(unique.temporaries, 4);
+#endif
+    ASSERT_GE(unique.construction_time, unique.max_construction_time);
+    ASSERT_GE(unique.max_construction_time, shared.max_construction_time);
+
+    auto statistics = observer_type::statistics();
+    ASSERT_EQ(statistics.size(), 3);
+    ASSERT_EQ(statistics[rtti<typeid_provider>::get_type_index<Class>()]
+                  .resolves,
+              3);
+}
+
+TEST_F(statistics_test, threads) {
+    using container_type = container<statistics_container_traits<float>>;
+    using observer_type = container_type::observer_type;
+
+    container_type container;
+    container.register_type<scope<unique>, storage<Class>>();
+
+    container.resolve<Class>();
+    std::thread thread([&] {
+        container.resolve<Class>();
+        container.resolve<Class>();
+    });
+    thread.join();
+
+    auto statistics = observer_type::statistics<Class>();
+    ASSERT_EQ(statistics.resolves, 3);
+    ASSERT_EQ(statistics.constructions, 3);
+}
+} // namespace dingo
@@ -0,0 +1,150 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/container.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+#include <dingo/timeline.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+#include "test.h"
+
+namespace dingo {
+template <typename Tag>
+struct timeline_container_traits : dynamic_container_traits {
+    using observer_type = timeline_observer<rtti_type, Tag>;
+};
+
+struct timeline_test : public test<void> {};
+
+struct timeline_a {
+    timeline_a() {}
+};
+
+struct timeline_b {
+    timeline_b(timeline_a&) {}
+};
+
+struct timeline_c {
+    timeline_c(timeline_b&&, timeline_a&) {}
+};
+
+TEST_F(timeline_test, nesting) {
+    using container_type = container<timeline_container_traits<int>>;
+    using observer_type = container_type::observer_type;
+
+    container_type container;
+    container.register_type<scope<shared>, storage<timeline_a>>();
+    container.register_type<scope<unique>, storage<timeline_b>>();
+    container.register_type<scope<unique>, storage<timeline_c>>();
+
+    container.resolve<timeline_c>();
+    auto timeline = observer_type::timeline();
+    ASSERT_EQ(timeline.events.size(), 3);
+
+    auto& c = timeline.events[0];
+    ASSERT_EQ(c.type, type_name<timeline_c>());
+    ASSERT_EQ(c.scope, type_name<unique>());
+    ASSERT_FALSE(c.parent);
+    ASSERT_EQ(c.depth, 0);
+    ASSERT_EQ(c.start.count(), 0);
+
+    auto& b = timeline.events[1];
+    ASSERT_EQ(b.type, type_name<timeline_b>());
+    ASSERT_EQ(b.parent, 0);
+    ASSERT_EQ(b.depth, 1);
+
+    // Shared instance is constructed once, while constructing timeline_b
+    auto& a = timeline.events[2];
+    ASSERT_EQ(a.type, type_name<timeline_a>());
+    ASSERT_EQ(a.scope, type_name<shared>());
+    ASSERT_EQ(a.parent, 1);
+    ASSERT_EQ(a.depth, 2);
+
+    ASSERT_GE(c.duration, b.duration);
+    ASSERT_GE(b.duration, a.duration);
+    ASSERT_GE(b.start, c.start);
+    ASSERT_EQ(timeline.self_time(0), c.duration - b.duration);
+    ASSERT_EQ(timeline.critical_path(), std::vector<std::size_t>({0, 1, 2}));
+
+    std::stringstream trace;
+    timeline.write_chrome_trace(trace);
+    ASSERT_EQ(trace.str().find("{\"traceEvents\":["), 0);
+    ASSERT_NE(trace.str().find("{\"name\":\"" +
+                               std::string(type_name<timeline_a>()) +
+                               "\",\"cat\":\"" +
+                               std::string(type_name<shared>()) +
+                               "\",\"ph\":\"X\",\"pid\":1,\"tid\":0,"),
+              std::string::npos);
+    ASSERT_NE(trace.str().find("\"critical\":true"), std::string::npos);
+
+    // Resolution that constructs the dependencies only
+    container.resolve<timeline_c>();
+    timeline = observer_type::timeline();
+    ASSERT_EQ(timeline.events.size(), 5);
+    ASSERT_EQ(timeline.events[4].parent, 3);
+
+    observer_type::clear();
+    ASSERT_TRUE(observer_type::timeline().events.empty());
+}
+
+TEST_F(timeline_test, threads) {
+    using container_type = container<timeline_container_traits<float>>;
+    using observer_type = container_type::observer_type;
+
+    container_type container;
+    container.register_type<scope<unique>, storage<timeline_a>>();
+
+    container.resolve<timeline_a>();
+    std::thread thread([&] { container.resolve<timeline_a>(); });
+    thread.join();
+
+    auto timeline = observer_type::timeline();
+    ASSERT_EQ(timeline.events.size(), 2);
+    ASSERT_EQ(timeline.events[0].thread, 0);
+    ASSERT_EQ(timeline.events[1].thread, 1);
+    ASSERT_FALSE(timeline.events[1].parent);
+    ASSERT_EQ(timeline.critical_path().size(), 1);
+}
+
+TEST_F(timeline_test, critical_path) {
+    using namespace std::chrono_literals;
+    auto event = [](std::optional<std::size_t> parent,
+                    std::chrono::nanoseconds duration) {
+        construction_timeline::event e;
+        e.type = "type\\\"\n";
+        e.parent = parent;
+        e.duration = duration;
+        return e;
+    };
+
+    // The longest nested construction of the root spends little time in
+    // itself, the shorter one waits for a slow dependency
+    construction_timeline timeline;
+    timeline.events = {event({}, 100ns), event(0, 60ns), event(1, 25ns),
+                       event(1, 25ns),   event(0, 40ns), event(4, 38ns)};
+    ASSERT_EQ(timeline.self_times(),
+              std::vector<std::chrono::nanoseconds>(
+                  {0ns, 10ns, 25ns, 25ns, 2ns, 38ns}));
+    for (std::size_t i = 0; i < timeline.events.size(); ++i)
+        ASSERT_EQ(timeline.self_time(i), timeline.self_times()[i]);
+    ASSERT_EQ(timeline.critical_path(), std::vector<std::size_t>({0, 4, 5}));
+
+    timeline.events[4].duration = 30ns;
+    timeline.events[5].duration = 25ns;
+    ASSERT_EQ(timeline.critical_path(), std::vector<std::size_t>({0, 1, 2}));
+
+    std::stringstream trace;
+    timeline.write_chrome_trace(trace);
+    ASSERT_NE(trace.str().find("{\"name\":\"type\\\\\\\"\\n\""),
+              std::string::npos);
+}
+} // namespace dingo
@@ -251,4 +251,83 @@ TYPED_TEST(unique_test, ambiguous_resolve) {
         4);
 }
 
+TYPED_TEST(unique_test, resolve_into) {
+    using container_type = TypeParam;
+
+    struct B : ClassTag<1> {
+        B(Class&& c) : c_(std::move(c)) {}
+        Class c_;
+    };
+
+    {
+        container_type container;
+        container.template register_type<scope<unique>, storage<Class>>();
+        container.template register_type<scope<unique>, storage<B>>();
+
+        alignas(std::max_align_t) uint8_t buffer[1024];
+        arena<> arena(buffer);
+        resolving_context::arena_closure closure(arena);
+
+        auto& b = container.template resolve_into<B>(closure);
+        AssertClass(b.c_);
+        ASSERT_GE(reinterpret_cast<uint8_t*>(&b), buffer);
+        ASSERT_LT(reinterpret_cast<uint8_t*>(&b), buffer + sizeof(buffer));
+        ASSERT_EQ(B::Constructor, 1);
+        // Only the instance living in the arena is left
+        ASSERT_EQ(B::GetTotalInstances() - B::Destructor, 1);
+
+        auto& c = container.template resolve_into<Class>(closure);
+        ASSERT_GE(reinterpret_cast<uint8_t*>(&c), buffer);
+        ASSERT_LT(reinterpret_cast<uint8_t*>(&c), buffer + sizeof(buffer));
+
+        closure.reset();
+        ASSERT_EQ(B::Destructor, B::GetTotalInstances());
+        ASSERT_EQ(Class::Destructor, Class::GetTotalInstances());
+    }
+
+    ASSERT_EQ(Class::Destructor, Class::GetTotalInstances());
+}
+
+TYPED_TEST(unique_test, resolve_into_shared_ptr) {
+    using container_type = TypeParam;
+
+    struct A : ClassTag<1> {};
+    struct B : ClassTag<2> {
+        B(std::shared_ptr<A> a) : a_(std::move(a)) {}
+        std::shared_ptr<A> a_;
+    };
+
+    {
+        container_type container;
+        container.template register_type<scope<unique>,
+                                         storage<std::shared_ptr<A>>>();
+        container.template register_type<scope<unique>,
+                                         storage<std::shared_ptr<B>>>();
+
+        alignas(std::max_align_t) uint8_t buffer[1024];
+        arena<> arena(buffer);
+        resolving_context::arena_closure closure(arena);
+
+        // Instances and their control blocks are allocated from the arena
+        auto& b = container.template resolve_into<std::shared_ptr<B>>(closure);
+        ASSERT_GE(reinterpret_cast<uint8_t*>(b.get()), buffer);
+        ASSERT_LT(reinterpret_cast<uint8_t*>(b.get()), buffer + sizeof(buffer));
+        ASSERT_GE(reinterpret_cast<uint8_t*>(b->a_.get()), buffer);
+        ASSERT_LT(reinterpret_cast<uint8_t*>(b->a_.get()),
+                  buffer + sizeof(buffer));
+        ASSERT_FALSE(arena.spilled());
+        ASSERT_EQ(B::Constructor, 1);
+
+        closure.reset();
+        ASSERT_EQ(B::Destructor, B::GetTotalInstances());
+        ASSERT_EQ(A::Destructor, A::GetTotalInstances());
+
+        // Resolutions outside of resolve_into() allocate as before
+        auto a = container.template resolve<std::shared_ptr<A>>();
+        ASSERT_FALSE(reinterpret_cast<uint8_t*>(a.get()) >= buffer &&
+                     reinterpret_cast<uint8_t*>(a.get()) <
+                         buffer + sizeof(buffer));
+    }
+}
+
 } // namespace dingo
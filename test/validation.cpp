@@ -0,0 +1,200 @@
+//
+// This file is part of dingo project <https://github.com/romanpauk/dingo>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <dingo/annotated.h>
+#include <dingo/container.h>
+#include <dingo/factory/callable.h>
+#include <dingo/factory/constructor.h>
+#include <dingo/storage/shared.h>
+#include <dingo/storage/unique.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "class.h"
+#include "test.h"
+
+namespace dingo {
+struct validation_test : public test<void> {};
+
+using validation_container =
+    container<diagnostics_container_traits<dynamic_container_traits>>;
+
+struct validation_a {
+    validation_a() {}
+};
+
+struct validation_tag {};
+
+struct validation_missing {
+    validation_missing() {}
+};
+
+struct validation_b {
+    validation_b(validation_a&, std::shared_ptr<IClass>) {}
+};
+
+struct validation_c {
+    validation_c(validation_missing&) {}
+};
+
+struct validation_d {
+    validation_d(validation_a&&) {}
+};
+
+struct validation_e {
+    validation_e(annotated<validation_a&, validation_tag>) {}
+};
+
+struct validation_f {
+    validation_f(IClass&) {}
+};
+
+struct validation_aggregate {
+    validation_a& a;
+    validation_missing& missing;
+};
+
+struct validation_g {
+    validation_g(validation_aggregate) {}
+};
+
+struct validation_h {
+    validation_h(validation_a&) {}
+    validation_h(IClass*) {}
+};
+
+template <typename Container> std::string validate(Container& container) {
+    try {
+        container.validate();
+    } catch (const type_validation_exception& e) {
+        return e.what();
+    }
+    return {};
+}
+
+TEST_F(validation_test, valid) {
+    validation_container container;
+    container.register_type<scope<shared>, storage<validation_a>>();
+    container.register_type<scope<shared>, storage<std::shared_ptr<Class>>,
+                            interfaces<IClass>>();
+    container.register_type<scope<unique>, storage<validation_b>>();
+    container.register_type<scope<unique>, storage<validation_e>>();
+    container.register_type<scope<shared>, storage<validation_a>,
+                            interfaces<annotated<validation_a, validation_tag>>>();
+    container.register_type<scope<unique>, storage<std::string>>(
+        callable([](validation_a&, IClass&) { return std::string(); }));
+    container.register_type<scope<unique>, storage<validation_h>,
+                            factory<constructor<validation_h(validation_a&)>>>();
+    container.register_type_collection<scope<unique>,
+                                       storage<std::vector<IClass*>>>();
+
+    ASSERT_NO_THROW(container.validate());
+    ASSERT_EQ(Class::GetTotalInstances(), 0);
+}
+
+TEST_F(validation_test, missing) {
+    validation_container container;
+    container.register_type<scope<unique>, storage<validation_c>>();
+    container.register_type<scope<unique>, storage<std::string>>(
+        callable([](validation_a&) { return std::string(); }));
+    container.register_type<scope<unique>, storage<validation_h>,
+                            factory<constructor<validation_h(IClass*)>>>();
+
+    auto errors = validate(container);
+    ASSERT_NE(errors.find(std::string(type_name<validation_c>()) + ": " +
+                          std::string(type_name<validation_missing&>()) +
+                          " is not registered"),
+              std::string::npos);
+    ASSERT_NE(errors.find(std::string(type_name<std::string>()) + ": " +
+                          std::string(type_name<validation_a&>()) +
+                          " is not registered"),
+              std::string::npos);
+    ASSERT_NE(errors.find(std::string(type_name<validation_h>()) + ": " +
+                          std::string(type_name<IClass*>()) +
+                          " is not registered"),
+              std::string::npos);
+
+    ASSERT_THROW(container.resolve<validation_c>(), type_not_found_exception);
+}
+
+TEST_F(validation_test, not_convertible) {
+    validation_container container;
+    container.register_type<scope<shared>, storage<validation_a>>();
+    container.register_type<scope<unique>, storage<validation_d>>();
+
+    auto errors = validate(container);
+    ASSERT_NE(errors.find(std::string(type_name<validation_a&&>()) +
+                          " is not convertible"),
+              std::string::npos);
+    ASSERT_THROW(container.resolve<validation_d>(),
+                 type_not_convertible_exception);
+}
+
+TEST_F(validation_test, ambiguous) {
+    validation_container container;
+    container.register_type<scope<shared>, storage<ClassTag<0>>,
+                            interfaces<IClass>>();
+    container.register_type<scope<shared>, storage<ClassTag<1>>,
+                            interfaces<IClass>>();
+    container.register_type<scope<unique>, storage<validation_f>>();
+
+    auto errors = validate(container);
+    ASSERT_NE(errors.find(std::string(type_name<IClass&>()) + " is ambiguous"),
+              std::string::npos);
+    ASSERT_THROW(container.resolve<validation_f>(), type_ambiguous_exception);
+}
+
+TEST_F(validation_test, aggregate) {
+    validation_container container;
+    container.register_type<scope<shared>, storage<validation_a>>();
+    container.register_type<scope<unique>, storage<validation_g>>();
+
+    auto errors = validate(container);
+    ASSERT_NE(errors.find(std::string(type_name<validation_g>()) + ": " +
+                          std::string(type_name<validation_missing&>()) +
+                          " is not registered"),
+              std::string::npos);
+    ASSERT_EQ(errors.find(type_name<validation_a&>()), std::string::npos);
+
+    container.register_type<scope<shared>, storage<validation_missing>>();
+    ASSERT_NO_THROW(container.validate());
+}
+
+TEST_F(validation_test, nested) {
+    using container_type = validation_container;
+    container_type parent;
+    parent.register_type<scope<shared>, storage<validation_a>>();
+
+    container_type::child_container_type<void> child(&parent);
+    child.register_type<scope<unique>, storage<validation_c>>()
+        .register_type<scope<shared>, storage<validation_missing>>();
+    child.register_type<scope<unique>, storage<validation_d>>();
+    child.register_type<scope<unique>, storage<validation_b>>()
+        .register_type<scope<unique>, storage<validation_f>>();
+
+    // Dependencies resolved from the parent container and nested containers
+    // are valid, validation_d does not get an rvalue from shared scope and
+    // validation_f in the nested container lacks IClass
+    auto errors = validate(child);
+    ASSERT_EQ(errors.find(type_name<validation_missing&>()), std::string::npos);
+    ASSERT_NE(errors.find(std::string(type_name<validation_d>()) + ": " +
+                          std::string(type_name<validation_a&&>()) +
+                          " is not convertible"),
+              std::string::npos);
+    ASSERT_NE(errors.find(std::string(type_name<validation_b>()) + ": " +
+                          std::string(type_name<std::shared_ptr<IClass>>()) +
+                          " is not registered"),
+              std::string::npos);
+    ASSERT_NE(errors.find(std::string(type_name<validation_f>()) + ": " +
+                          std::string(type_name<IClass&>()) +
+                          " is not registered"),
+              std::string::npos);
+}
+} // namespace dingo
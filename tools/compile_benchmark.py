@@ -0,0 +1,164 @@
+#
+# This file is part of dingo project <https://github.com/romanpauk/dingo>
+#
+# See LICENSE for license and copyright information
+# SPDX-License-Identifier: MIT
+#
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+# Generates translation units registering N types into a container and measures
+# compile time and object size with each of the given compilers.
+
+SCOPES = ["unique", "shared"]
+
+
+def dependency(i):
+    # Shared instances are injected by reference, unique ones by value
+    if SCOPES[i % len(SCOPES)] == "shared":
+        return "type{}&".format(i)
+    return "type{}".format(i)
+
+
+def generate(count, arity, factory, traits):
+    lines = []
+    lines.append("#include <dingo/container.h>")
+    lines.append("#include <dingo/factory/constructor.h>")
+    lines.append("#include <dingo/storage/shared.h>")
+    lines.append("#include <dingo/storage/unique.h>")
+    lines.append("")
+    lines.append("namespace {")
+    for i in range(count):
+        # Dependencies are the preceding types, so the last type resolves the
+        # whole graph and all factories are instantiated
+        deps = [dependency(j) for j in range(max(0, i - arity), i)]
+        lines.append("struct itype{} {{".format(i))
+        lines.append("    virtual ~itype{}() {{}}".format(i))
+        lines.append("};")
+        lines.append("struct type{} : itype{} {{".format(i, i))
+        lines.append("    type{}({}) {{}}".format(i, ", ".join(deps)))
+        lines.append("};")
+    lines.append("} // namespace")
+    lines.append("")
+
+    if traits == "static":
+        container = "dingo::container<dingo::static_container_traits<>>"
+    else:
+        container = "dingo::container<>"
+
+    lines.append("void resolve() {")
+    lines.append("    using namespace dingo;")
+    lines.append("    {} container;".format(container))
+    for i in range(count):
+        deps = [dependency(j) for j in range(max(0, i - arity), i)]
+        scope = SCOPES[i % len(SCOPES)]
+        args = []
+        args.append("scope<{}>".format(scope))
+        args.append("storage<type{}>".format(i))
+        if scope == "shared":
+            args.append("interfaces<type{}, itype{}>".format(i, i))
+        if factory == "constructor":
+            args.append("factory<constructor<type{}({})>>".format(
+                i, ", ".join(deps)))
+        lines.append("    container.register_type<{}>();".format(
+            ", ".join(args)))
+    for i in range(count):
+        lines.append("    container.resolve<{}>();".format(dependency(i)))
+    lines.append("}")
+    lines.append("")
+    return "\n".join(lines)
+
+
+def compile(compiler, flags, include, source, output, repeat):
+    command = [compiler] + flags + ["-I", include, "-c", source, "-o", output]
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        p = subprocess.run(command, stdout=subprocess.PIPE,
+                           stderr=subprocess.STDOUT)
+        elapsed = time.perf_counter() - start
+        if p.returncode != 0:
+            sys.stderr.write(p.stdout.decode())
+            raise Exception("compilation failed: {}".format(" ".join(command)))
+        best = elapsed if best is None else min(best, elapsed)
+    return best, os.path.getsize(output)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--compiler", action="append",
+                        help="compiler(s) to measure, c++ by default")
+    parser.add_argument("--include", default=os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "..", "include"),
+        help="dingo include directory")
+    parser.add_argument("--types", default="0,25,50,100",
+                        help="comma-separated counts of registered types")
+    parser.add_argument("--arity", type=int, default=4,
+                        help="maximal constructor arity")
+    parser.add_argument("--factory", choices=["detected", "constructor"],
+                        action="append",
+                        help="factory of registered types, both by default")
+    parser.add_argument("--traits", choices=["dynamic", "static"],
+                        default="dynamic", help="container traits")
+    parser.add_argument("--flags", default="-std=c++17 -O2",
+                        help="compiler flags")
+    parser.add_argument("--repeat", type=int, default=1,
+                        help="compilations per measurement, best is reported")
+    parser.add_argument("--output", help="json file with results")
+    args = parser.parse_args()
+
+    compilers = args.compiler or ["c++"]
+    factories = args.factory or ["detected", "constructor"]
+    counts = [int(count) for count in args.types.split(",")]
+
+    results = []
+    print("{:<24} {:<12} {:>6} {:>10} {:>12} {:>12}".format(
+        "compiler", "factory", "types", "time [s]", "per type [ms]",
+        "object [B]"))
+    with tempfile.TemporaryDirectory() as directory:
+        for compiler in compilers:
+            for factory in factories:
+                baseline = None
+                for count in counts:
+                    source = os.path.join(directory, "types{}.cpp".format(count))
+                    with open(source, "w") as f:
+                        f.write(generate(count, args.arity, factory,
+                                         args.traits))
+                    seconds, size = compile(
+                        compiler, args.flags.split(), args.include, source,
+                        os.path.join(directory, "types.o"), args.repeat)
+
+                    # Cost per type excludes the cost of parsing the headers
+                    if baseline is None:
+                        baseline = (count, seconds)
+                    per_type = 0.0
+                    if count > baseline[0]:
+                        per_type = (seconds - baseline[1]) / \
+                            (count - baseline[0]) * 1000
+
+                    results.append({
+                        "compiler": compiler,
+                        "factory": factory,
+                        "traits": args.traits,
+                        "types": count,
+                        "arity": args.arity,
+                        "seconds": seconds,
+                        "seconds_per_type": per_type / 1000,
+                        "object_bytes": size,
+                    })
+                    print("{:<24} {:<12} {:>6} {:>10.2f} {:>12.1f} {:>12}".format(
+                        os.path.basename(compiler), factory, count, seconds,
+                        per_type, size))
+                    sys.stdout.flush()
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+
+    sys.exit(0)